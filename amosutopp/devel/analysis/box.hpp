@@ -0,0 +1,134 @@
+#ifndef BOX_HPP
+#define BOX_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+// Periodic cell shapes, used as Box policies so that pair kernels are
+// compiled once per shape and never test the shape inside the pair loop
+struct Orthorhombic {};
+struct Triclinic {};
+
+template <class Shape>
+class Box;
+
+template <>
+class Box<Orthorhombic> {
+public:
+    explicit Box(const std::array<double, 3>& lengths) : length(lengths) {
+        for (int d = 0; d < 3; ++d) inverse[d] = 1.0 / length[d];
+    }
+
+    // Branchless minimum image: subtract the nearest lattice translation
+    void minimum_image(double& dx, double& dy, double& dz) const {
+        dx -= length[0] * std::nearbyint(dx * inverse[0]);
+        dy -= length[1] * std::nearbyint(dy * inverse[1]);
+        dz -= length[2] * std::nearbyint(dz * inverse[2]);
+    }
+
+    // Fractional coordinates along the three cell vectors
+    void fractional(double x, double y, double z, double s[3]) const {
+        s[0] = x * inverse[0];
+        s[1] = y * inverse[1];
+        s[2] = z * inverse[2];
+    }
+
+    // Distance between the two faces opposite cell vector d
+    double width(int d) const { return length[d]; }
+    double min_width() const { return std::min({length[0], length[1], length[2]}); }
+    double volume() const { return length[0] * length[1] * length[2]; }
+
+    // Cell matrix, row-major with the cell vectors as columns
+    std::array<double, 9> matrix() const {
+        return {length[0], 0.0, 0.0, 0.0, length[1], 0.0, 0.0, 0.0, length[2]};
+    }
+
+private:
+    std::array<double, 3> length;
+    std::array<double, 3> inverse;
+};
+
+// Upper-triangular cell matrix with the cell vectors as columns, as returned
+// by chemfiles::UnitCell::matrix(): a = (ax, 0, 0), b = (bx, by, 0), c = (cx, cy, cz)
+template <>
+class Box<Triclinic> {
+public:
+    template <class Matrix>
+    explicit Box(const Matrix& m) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) h[3 * i + j] = m[i][j];
+        }
+        if (h[3] != 0.0 || h[6] != 0.0 || h[7] != 0.0) {
+            throw std::runtime_error("Box<Triclinic> needs an upper-triangular cell matrix");
+        }
+        inverse_diagonal = {1.0 / h[0], 1.0 / h[4], 1.0 / h[8]};
+
+        // Face distances are V / |cross product of the other two vectors|
+        double v = volume();
+        double a[3] = {h[0], h[3], h[6]}, b[3] = {h[1], h[4], h[7]}, c[3] = {h[2], h[5], h[8]};
+        face_width[0] = v / cross_norm(b, c);
+        face_width[1] = v / cross_norm(c, a);
+        face_width[2] = v / cross_norm(a, b);
+    }
+
+    // Branchless minimum image by reducing along c, then b, then a. Exact for
+    // separations below min_width() / 2 in the usual restricted triclinic
+    // cells (|bx| <= ax / 2, etc.), which is all the cutoff kernels need
+    void minimum_image(double& dx, double& dy, double& dz) const {
+        double s = std::nearbyint(dz * inverse_diagonal[2]);
+        dx -= h[2] * s;
+        dy -= h[5] * s;
+        dz -= h[8] * s;
+
+        s = std::nearbyint(dy * inverse_diagonal[1]);
+        dx -= h[1] * s;
+        dy -= h[4] * s;
+
+        s = std::nearbyint(dx * inverse_diagonal[0]);
+        dx -= h[0] * s;
+    }
+
+    void fractional(double x, double y, double z, double s[3]) const {
+        s[2] = z * inverse_diagonal[2];
+        s[1] = (y - h[5] * s[2]) * inverse_diagonal[1];
+        s[0] = (x - h[1] * s[1] - h[2] * s[2]) * inverse_diagonal[0];
+    }
+
+    double width(int d) const { return face_width[d]; }
+    double min_width() const { return std::min({face_width[0], face_width[1], face_width[2]}); }
+    double volume() const { return h[0] * h[4] * h[8]; }
+    std::array<double, 9> matrix() const { return h; }
+
+private:
+    static double cross_norm(const double u[3], const double v[3]) {
+        double x = u[1] * v[2] - u[2] * v[1];
+        double y = u[2] * v[0] - u[0] * v[2];
+        double z = u[0] * v[1] - u[1] * v[0];
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    std::array<double, 9> h;
+    std::array<double, 3> inverse_diagonal;
+    std::array<double, 3> face_width;
+};
+
+// Calls f(box) with the Box matching the shape of a chemfiles::UnitCell,
+// once per frame, so the kernel f instantiates is specialised for it
+template <class Cell, class F>
+decltype(auto) with_box(const Cell& cell, F&& f) {
+    switch (cell.shape()) {
+    case Cell::ORTHORHOMBIC: {
+        auto lengths = cell.lengths();
+        return std::forward<F>(f)(Box<Orthorhombic>({lengths[0], lengths[1], lengths[2]}));
+    }
+    case Cell::TRICLINIC:
+        return std::forward<F>(f)(Box<Triclinic>(cell.matrix()));
+    default:
+        throw std::runtime_error("with_box: periodic analysis needs an orthorhombic or triclinic cell");
+    }
+}
+
+#endif // BOX_HPP
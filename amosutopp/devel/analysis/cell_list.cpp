@@ -0,0 +1,63 @@
+#include "cell_list.hpp"
+#include <algorithm>
+#include <cmath>
+
+template <class Shape>
+void CellList::build(const std::vector<double>& positions, const Box<Shape>& box, double min_width) {
+    size_t n_particles = positions.size() / 3;
+
+    for (int d = 0; d < 3; ++d) {
+        n_cells[d] = std::max(1, static_cast<int>(box.width(d) / min_width));
+    }
+    size_t total_cells = static_cast<size_t>(n_cells[0]) * n_cells[1] * n_cells[2];
+
+    // Counting sort of the particles by cell, fractional coordinates wrapped into [0, 1)
+    std::vector<size_t> cell_of(n_particles);
+    cell_start.assign(total_cells + 1, 0);
+    for (size_t i = 0; i < n_particles; ++i) {
+        double s[3];
+        box.fractional(positions[3 * i + 0], positions[3 * i + 1], positions[3 * i + 2], s);
+        int c[3];
+        for (int d = 0; d < 3; ++d) {
+            double x = s[d] - std::floor(s[d]);
+            c[d] = std::min(static_cast<int>(x * n_cells[d]), n_cells[d] - 1);
+        }
+        cell_of[i] = (static_cast<size_t>(c[0]) * n_cells[1] + c[1]) * n_cells[2] + c[2];
+        cell_start[cell_of[i] + 1]++;
+    }
+    for (size_t c = 0; c < total_cells; ++c) cell_start[c + 1] += cell_start[c];
+
+    sorted.resize(3 * n_particles);
+    order.resize(n_particles);
+    std::vector<size_t> fill(cell_start.begin(), cell_start.end() - 1);
+    for (size_t i = 0; i < n_particles; ++i) {
+        size_t slot = fill[cell_of[i]]++;
+        sorted[3 * slot + 0] = positions[3 * i + 0];
+        sorted[3 * slot + 1] = positions[3 * i + 1];
+        sorted[3 * slot + 2] = positions[3 * i + 2];
+        order[slot] = i;
+    }
+}
+
+template void CellList::build(const std::vector<double>&, const Box<Orthorhombic>&, double);
+template void CellList::build(const std::vector<double>&, const Box<Triclinic>&, double);
+
+void CellList::neighbour_cells(size_t cell, std::vector<size_t>& out) const {
+    int cx = static_cast<int>(cell / (static_cast<size_t>(n_cells[1]) * n_cells[2]));
+    int cy = static_cast<int>((cell / n_cells[2]) % n_cells[1]);
+    int cz = static_cast<int>(cell % n_cells[2]);
+
+    out.clear();
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                int nx = (cx + dx + n_cells[0]) % n_cells[0];
+                int ny = (cy + dy + n_cells[1]) % n_cells[1];
+                int nz = (cz + dz + n_cells[2]) % n_cells[2];
+                out.push_back((static_cast<size_t>(nx) * n_cells[1] + ny) * n_cells[2] + nz);
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
@@ -0,0 +1,27 @@
+#ifndef CELL_LIST_HPP
+#define CELL_LIST_HPP
+
+#include "box.hpp"
+#include <cstddef>
+#include <vector>
+
+// Particles counting-sorted into cells at least `min_width` wide (face to
+// face) in a periodic box, binned along the fractional coordinates, so every
+// pair closer than min_width lies in the same or in adjacent cells
+struct CellList {
+    int n_cells[3];
+    std::vector<size_t> cell_start;     // slots of cell c are [cell_start[c], cell_start[c + 1])
+    std::vector<size_t> order;          // original particle index of every slot
+    std::vector<double> sorted;         // xyz of every slot
+
+    template <class Shape>
+    void build(const std::vector<double>& positions, const Box<Shape>& box, double min_width);
+
+    size_t n_total() const { return cell_start.size() - 1; }
+
+    // Unique periodic neighbour cells of `cell`, itself included (small
+    // boxes would otherwise repeat some of the 27)
+    void neighbour_cells(size_t cell, std::vector<size_t>& out) const;
+};
+
+#endif // CELL_LIST_HPP
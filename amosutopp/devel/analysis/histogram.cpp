@@ -0,0 +1,86 @@
+#include "histogram.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace {
+    constexpr size_t DOUBLES_PER_LINE = 64 / sizeof(double);
+}
+
+Histogram::Histogram(size_t n_bins, int n_threads)
+    : n_bins(n_bins),
+      stride(((n_bins + DOUBLES_PER_LINE - 1) / DOUBLES_PER_LINE) * DOUBLES_PER_LINE),
+      n_threads(std::max(n_threads, 1)),
+      offset(0),
+      storage(stride * std::max(n_threads, 1) + DOUBLES_PER_LINE, 0.0) {
+    // Align the first copy to a cache line; the stride keeps the others aligned
+    auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+    offset = ((64 - address % 64) % 64) / sizeof(double);
+}
+
+void Histogram::clear() {
+    std::fill(storage.begin(), storage.end(), 0.0);
+}
+
+void Histogram::merge() {
+    for (int step = 1; step < n_threads; step *= 2) {
+        // Copy t absorbs copy t + step; the pairs of a round are independent
+        #pragma omp parallel for schedule(static)
+        for (int t = 0; t < n_threads - step; t += 2 * step) {
+            double* into = thread_bins(t);
+            const double* from = thread_bins(t + step);
+
+            #pragma omp simd
+            for (size_t b = 0; b < n_bins; ++b) into[b] += from[b];
+        }
+    }
+}
+
+#if defined(__AVX512F__) && defined(__AVX512CD__)
+
+// Population count of each 32-bit lane using AVX-512F only
+static inline __m512i popcount_epi32(__m512i v) {
+    const __m512i m1 = _mm512_set1_epi32(0x55555555);
+    const __m512i m2 = _mm512_set1_epi32(0x33333333);
+    const __m512i m4 = _mm512_set1_epi32(0x0f0f0f0f);
+    v = _mm512_sub_epi32(v, _mm512_and_si512(_mm512_srli_epi32(v, 1), m1));
+    v = _mm512_add_epi32(_mm512_and_si512(v, m2), _mm512_and_si512(_mm512_srli_epi32(v, 2), m2));
+    v = _mm512_and_si512(_mm512_add_epi32(v, _mm512_srli_epi32(v, 4)), m4);
+    return _mm512_srli_epi32(_mm512_mullo_epi32(v, _mm512_set1_epi32(0x01010101)), 24);
+}
+
+void Histogram::add_batch(double* bins, const int* indices, size_t n, double weight) {
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512d w = _mm512_set1_pd(weight);
+
+    size_t k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512i idx = _mm512_loadu_si512(indices + k);
+
+        // Lane i counts itself plus every earlier lane with the same index,
+        // so the last duplicate carries the full increment
+        __m512i count = _mm512_add_epi32(popcount_epi32(_mm512_conflict_epi32(idx)), one);
+
+        __m256i idx_lo = _mm512_castsi512_si256(idx);
+        __m256i idx_hi = _mm512_extracti64x4_epi64(idx, 1);
+        __m512d old_lo = _mm512_i32gather_pd(idx_lo, bins, 8);
+        __m512d old_hi = _mm512_i32gather_pd(idx_hi, bins, 8);
+
+        __m512d inc_lo = _mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(count)), w);
+        __m512d inc_hi = _mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(count, 1)), w);
+
+        // Overlapping scatter writes are ordered from low to high lanes
+        _mm512_i32scatter_pd(bins, idx_lo, _mm512_add_pd(old_lo, inc_lo), 8);
+        _mm512_i32scatter_pd(bins, idx_hi, _mm512_add_pd(old_hi, inc_hi), 8);
+    }
+
+    for (; k < n; ++k) bins[indices[k]] += weight;
+}
+
+#else
+
+void Histogram::add_batch(double* bins, const int* indices, size_t n, double weight) {
+    for (size_t k = 0; k < n; ++k) bins[indices[k]] += weight;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <cstddef>
+#include <vector>
+#include <omp.h>
+
+// Histogram with one private copy of the bins per thread. Each copy starts
+// on its own cache line so threads never share a line, and merge() adds
+// the copies together pairwise in log2(n_threads) parallel rounds.
+class Histogram {
+public:
+    explicit Histogram(size_t n_bins, int n_threads = omp_get_max_threads());
+
+    // Private bins of `thread` (usually omp_get_thread_num())
+    double* thread_bins(int thread) { return base() + thread * stride; }
+
+    // Add `weight` to bins[indices[k]] for k < n. Uses an AVX-512CD
+    // conflict-detection gather/scatter when available, so repeated
+    // indices inside a batch are counted correctly.
+    static void add_batch(double* bins, const int* indices, size_t n, double weight = 1.0);
+
+    // Tree merge of all thread copies into the merged bins
+    void merge();
+
+    // Merged bins (valid after merge())
+    const double* bins() const { return base(); }
+    std::vector<double> to_vector() const { return std::vector<double>(bins(), bins() + n_bins); }
+
+    size_t size() const { return n_bins; }
+    int threads() const { return n_threads; }
+
+    void clear();
+
+private:
+    double* base() { return storage.data() + offset; }
+    const double* base() const { return storage.data() + offset; }
+
+    size_t n_bins;
+    size_t stride;          // n_bins rounded up to a whole cache line
+    int n_threads;
+    size_t offset;          // first 64-byte aligned element of storage
+    std::vector<double> storage;
+};
+
+#endif // HISTOGRAM_HPP
@@ -0,0 +1,111 @@
+#include "neighbor_list.hpp"
+#include "cell_list.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <omp.h>
+
+NeighborList::NeighborList(double cutoff, double skin, bool half)
+    : list_cutoff(cutoff), list_skin(skin), half(half), builds(0), reference_cell{} {
+    if (cutoff <= 0.0 || skin < 0.0) {
+        throw std::runtime_error("NeighborList needs cutoff > 0 and skin >= 0");
+    }
+}
+
+template <class Shape>
+bool NeighborList::update(const std::vector<double>& positions, const Box<Shape>& box) {
+    if (!needs_rebuild(positions, box)) return false;
+    build(positions, box);
+    return true;
+}
+
+template <class Shape>
+bool NeighborList::needs_rebuild(const std::vector<double>& positions, const Box<Shape>& box) const {
+    if (builds == 0 || positions.size() != reference.size() || box.matrix() != reference_cell) return true;
+
+    // Largest minimum-image displacement since the last build
+    double limit2 = 0.25 * list_skin * list_skin;
+    size_t n_atoms = positions.size() / 3;
+    double max2 = 0.0;
+
+    #pragma omp parallel for reduction(max:max2) schedule(static)
+    for (size_t i = 0; i < n_atoms; ++i) {
+        double dx = positions[3 * i + 0] - reference[3 * i + 0];
+        double dy = positions[3 * i + 1] - reference[3 * i + 1];
+        double dz = positions[3 * i + 2] - reference[3 * i + 2];
+        box.minimum_image(dx, dy, dz);
+        max2 = std::max(max2, dx * dx + dy * dy + dz * dz);
+    }
+
+    return max2 > limit2;
+}
+
+template <class Shape>
+void NeighborList::build(const std::vector<double>& positions, const Box<Shape>& box) {
+    size_t n_atoms = positions.size() / 3;
+    double r_list = list_cutoff + list_skin;
+    double r_list2 = r_list * r_list;
+
+    if (r_list > 0.5 * box.min_width()) {
+        throw std::runtime_error("NeighborList: cutoff + skin must not exceed half the box width");
+    }
+
+    CellList cells;
+    cells.build(positions, box, r_list);
+    const std::vector<double>& sorted = cells.sorted;
+
+    // Two passes over the cells, threaded: count, then fill the CSR arrays
+    std::vector<size_t> count(n_atoms + 1, 0);
+    neighbor_offsets.assign(n_atoms + 1, 0);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        #pragma omp parallel
+        {
+            std::vector<size_t> neighbours;
+
+            #pragma omp for schedule(dynamic)
+            for (size_t cell = 0; cell < cells.n_total(); ++cell) {
+                cells.neighbour_cells(cell, neighbours);
+
+                for (size_t a = cells.cell_start[cell]; a < cells.cell_start[cell + 1]; ++a) {
+                    size_t i = cells.order[a];
+                    size_t fill = (pass == 0) ? 0 : neighbor_offsets[i];
+
+                    for (size_t other : neighbours) {
+                        for (size_t b = cells.cell_start[other]; b < cells.cell_start[other + 1]; ++b) {
+                            size_t j = cells.order[b];
+                            if (j == i || (half && j < i)) continue;
+
+                            double dx = sorted[3 * a + 0] - sorted[3 * b + 0];
+                            double dy = sorted[3 * a + 1] - sorted[3 * b + 1];
+                            double dz = sorted[3 * a + 2] - sorted[3 * b + 2];
+                            box.minimum_image(dx, dy, dz);
+
+                            if (dx * dx + dy * dy + dz * dz < r_list2) {
+                                if (pass == 0) {
+                                    fill++;
+                                } else {
+                                    neighbor_indices[fill++] = j;
+                                }
+                            }
+                        }
+                    }
+
+                    if (pass == 0) count[i + 1] = fill;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (size_t i = 0; i < n_atoms; ++i) neighbor_offsets[i + 1] = neighbor_offsets[i] + count[i + 1];
+            neighbor_indices.resize(neighbor_offsets[n_atoms]);
+        }
+    }
+
+    reference = positions;
+    reference_cell = box.matrix();
+    builds++;
+}
+
+template bool NeighborList::update(const std::vector<double>&, const Box<Orthorhombic>&);
+template bool NeighborList::update(const std::vector<double>&, const Box<Triclinic>&);
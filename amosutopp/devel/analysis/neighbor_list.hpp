@@ -0,0 +1,48 @@
+#ifndef NEIGHBOR_LIST_HPP
+#define NEIGHBOR_LIST_HPP
+
+#include "box.hpp"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Verlet neighbour list with a skin, reused across frames. Pairs closer
+// than cutoff + skin are stored; the list is only rebuilt once some atom
+// has moved more than skin / 2 since the last build (or the box or the
+// number of atoms changed), so it stays valid for every pair within cutoff.
+class NeighborList {
+public:
+    // A half list stores each pair once (j > i), a full list under both atoms
+    NeighborList(double cutoff, double skin, bool half = true);
+
+    // Rebuild if needed for these positions; returns true if it was rebuilt
+    template <class Shape>
+    bool update(const std::vector<double>& positions, const Box<Shape>& box);
+
+    // Neighbours of atom i are neighbors()[offsets()[i] .. offsets()[i + 1])
+    const std::vector<size_t>& offsets() const { return neighbor_offsets; }
+    const std::vector<size_t>& neighbors() const { return neighbor_indices; }
+
+    double cutoff() const { return list_cutoff; }
+    double skin() const { return list_skin; }
+    bool is_half() const { return half; }
+    size_t n_builds() const { return builds; }
+
+private:
+    template <class Shape>
+    bool needs_rebuild(const std::vector<double>& positions, const Box<Shape>& box) const;
+    template <class Shape>
+    void build(const std::vector<double>& positions, const Box<Shape>& box);
+
+    double list_cutoff;
+    double list_skin;
+    bool half;
+    size_t builds;
+
+    std::array<double, 9> reference_cell;  // cell matrix at the last build
+    std::vector<double> reference;          // positions at the last build
+    std::vector<size_t> neighbor_offsets;   // CSR row offsets, n_atoms + 1
+    std::vector<size_t> neighbor_indices;
+};
+
+#endif // NEIGHBOR_LIST_HPP
@@ -1,19 +1,34 @@
 #include "perform_analysis.hpp"
+#include "../frame_prefetcher.hpp"
 #include </opt/homebrew/Cellar/open-mpi/5.0.3_1/include/mpi.h>
 
-void perform_analysis(Analysis* analysis, TrajectoryHandler& trajectory_handler, MPIHandler& mpi_handler) {
+void perform_analysis(Analysis* analysis, TrajectoryHandler& trajectory_handler, MPIHandler& mpi_handler,
+                      size_t prefetch_depth, const FrameRange& range) {
     // Broadcast the total number of frames
     size_t n_frames = trajectory_handler.get_n_frames();
     MPI_Bcast(&n_frames, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
 
-    // Calculate the frames each process should handle
-    size_t frames_per_process = n_frames / mpi_handler.get_world_size();
-    size_t start_frame = mpi_handler.get_world_rank() * frames_per_process;
-    size_t end_frame = (mpi_handler.get_world_rank() == mpi_handler.get_world_size() - 1) ? n_frames : start_frame + frames_per_process;
+    // Calculate the frames each process should handle, out of the selected ones
+    std::vector<size_t> frames = range.frames(n_frames);
+    size_t frames_per_process = frames.size() / mpi_handler.get_world_size();
+    size_t start = mpi_handler.get_world_rank() * frames_per_process;
+    size_t end = (mpi_handler.get_world_rank() == mpi_handler.get_world_size() - 1) ? frames.size() : start + frames_per_process;
+    if (start == end) return;
 
     // Each process processes its assigned frames
-    for (size_t i = start_frame; i < end_frame; ++i) {
-        auto frame = trajectory_handler.read_frame(i);
-        analysis->analyze_frame(frame, i);  // Pass the frame number (i)
+    if (prefetch_depth == 0) {
+        FrameBuffer buffer;  // reused for every frame
+        for (size_t k = start; k < end; ++k) {
+            trajectory_handler.read_into(frames[k], buffer);
+            analysis->analyze_frame(buffer.frame, frames[k]);  // Pass the frame number
+        }
+        return;
+    }
+
+    // Decode the next frames while this one is analysed
+    FramePrefetcher prefetcher(trajectory_handler, frames[start], frames[end - 1] + 1, prefetch_depth, range.stride);
+    while (const FrameBuffer* slot = prefetcher.acquire()) {
+        analysis->analyze_frame(slot->frame, slot->index);
+        prefetcher.release();
     }
 }
\ No newline at end of file
@@ -2,9 +2,14 @@
 #define PERFORM_ANALYSIS_HPP
 
 #include "../mpi_handler.hpp"
+#include "../frame_selection.hpp"
 #include "../trajectory_handler.hpp"
 #include "analysis.hpp"
 
-void perform_analysis(Analysis* analysis, TrajectoryHandler& trajectory_handler, MPIHandler& mpi_handler);
+// Frames of `range` are split between the processes, and read
+// `prefetch_depth` ahead on a background thread while the analysis runs; a
+// depth of 0 reads each frame in turn. Frames outside the range are never read
+void perform_analysis(Analysis* analysis, TrajectoryHandler& trajectory_handler, MPIHandler& mpi_handler,
+                      size_t prefetch_depth = 2, const FrameRange& range = {});
 
 #endif // PERFORM_ANALYSIS_HPP
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include "rdf.hpp"
+#include "histogram.hpp"
+#include "cell_list.hpp"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <utility>
 #include <vector>
+#include <omp.h>
 
 void compute_rdf_cpu(const std::vector<double>& positions, std::vector<double>& rdf, double bin_size, int num_bins) {
     // Initialize RDF bins to zero
@@ -22,4 +28,221 @@ void compute_rdf_cpu(const std::vector<double>& positions, std::vector<double>&
             }
         }
     }
-}
\ No newline at end of file
+}
+
+int rdf_pair_index(int a, int b, int n_types) {
+    if (a > b) std::swap(a, b);
+    return a * n_types - a * (a - 1) / 2 + (b - a);
+}
+
+// Single linked-cell sweep counting every pair closer than r_max once, into
+// the histogram of its type pair: counts[rdf_pair_index(a, b) * num_bins + bin].
+// `types` may be null, in which case every particle has type 0.
+template <class Shape>
+static std::vector<double> cell_list_pair_counts(const std::vector<double>& positions, const int* types, int n_types,
+                                                 const Box<Shape>& box, double bin_size, int num_bins) {
+    size_t n_particles = positions.size() / 3;
+    double r_max = bin_size * num_bins;
+    double r_max2 = r_max * r_max;
+
+    if (r_max > 0.5 * box.min_width()) {
+        throw std::runtime_error("compute_rdf_cell_list: r_max must not exceed half the box width");
+    }
+
+    CellList cells;
+    cells.build(positions, box, r_max);
+    const std::vector<double>& sorted = cells.sorted;
+
+    std::vector<int> sorted_type(n_particles, 0);
+    if (types) {
+        for (size_t slot = 0; slot < n_particles; ++slot) sorted_type[slot] = types[cells.order[slot]];
+    }
+
+    // Packed upper triangle of type pairs, num_bins bins each
+    int n_pairs = n_types * (n_types + 1) / 2;
+    Histogram counts(static_cast<size_t>(n_pairs) * num_bins);
+    double inv_bin = 1.0 / bin_size;
+
+    #pragma omp parallel
+    {
+        // Thread-private bins, filled in batches of bin indices
+        double* local = counts.thread_bins(omp_get_thread_num());
+        constexpr size_t batch_size = 64;
+        int batch[batch_size];
+        size_t n_batch = 0;
+        std::vector<size_t> neighbours;
+
+        #pragma omp for schedule(dynamic)
+        for (size_t cell = 0; cell < cells.n_total(); ++cell) {
+            cells.neighbour_cells(cell, neighbours);
+
+            for (size_t a = cells.cell_start[cell]; a < cells.cell_start[cell + 1]; ++a) {
+                const int type_a = sorted_type[a];
+                for (size_t other : neighbours) {
+                    for (size_t b = cells.cell_start[other]; b < cells.cell_start[other + 1]; ++b) {
+                        if (b <= a) continue;  // each pair once
+
+                        double dx = sorted[3 * a + 0] - sorted[3 * b + 0];
+                        double dy = sorted[3 * a + 1] - sorted[3 * b + 1];
+                        double dz = sorted[3 * a + 2] - sorted[3 * b + 2];
+
+                        box.minimum_image(dx, dy, dz);
+
+                        double r2 = dx * dx + dy * dy + dz * dz;
+                        if (r2 < r_max2) {
+                            int bin = static_cast<int>(std::sqrt(r2) * inv_bin);
+                            if (bin < num_bins) {
+                                batch[n_batch++] = rdf_pair_index(type_a, sorted_type[b], n_types) * num_bins + bin;
+                                if (n_batch == batch_size) {
+                                    Histogram::add_batch(local, batch, n_batch);
+                                    n_batch = 0;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        Histogram::add_batch(local, batch, n_batch);
+    }
+    counts.merge();
+
+    return counts.to_vector();
+}
+
+// Same counts as cell_list_pair_counts(), reading the pairs from a half
+// neighbour list whose cutoff covers r_max
+template <class Shape>
+static std::vector<double> neighbor_list_pair_counts(const std::vector<double>& positions, const int* types, int n_types,
+                                                     const Box<Shape>& box, const NeighborList& list,
+                                                     double bin_size, int num_bins) {
+    size_t n_particles = positions.size() / 3;
+    double r_max = bin_size * num_bins;
+    double r_max2 = r_max * r_max;
+
+    if (!list.is_half() || list.cutoff() < r_max) {
+        throw std::runtime_error("RDF needs a half neighbour list with a cutoff of at least r_max");
+    }
+
+    int n_pairs = n_types * (n_types + 1) / 2;
+    Histogram counts(static_cast<size_t>(n_pairs) * num_bins);
+    double inv_bin = 1.0 / bin_size;
+    const std::vector<size_t>& offsets = list.offsets();
+    const std::vector<size_t>& neighbors = list.neighbors();
+
+    #pragma omp parallel
+    {
+        double* local = counts.thread_bins(omp_get_thread_num());
+        constexpr size_t batch_size = 64;
+        int batch[batch_size];
+        size_t n_batch = 0;
+
+        #pragma omp for schedule(dynamic, 256)
+        for (size_t i = 0; i < n_particles; ++i) {
+            const int type_i = types ? types[i] : 0;
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                size_t j = neighbors[k];
+
+                double dx = positions[3 * i + 0] - positions[3 * j + 0];
+                double dy = positions[3 * i + 1] - positions[3 * j + 1];
+                double dz = positions[3 * i + 2] - positions[3 * j + 2];
+                box.minimum_image(dx, dy, dz);
+
+                double r2 = dx * dx + dy * dy + dz * dz;
+                if (r2 < r_max2) {
+                    int bin = static_cast<int>(std::sqrt(r2) * inv_bin);
+                    if (bin < num_bins) {
+                        batch[n_batch++] = rdf_pair_index(type_i, types ? types[j] : 0, n_types) * num_bins + bin;
+                        if (n_batch == batch_size) {
+                            Histogram::add_batch(local, batch, n_batch);
+                            n_batch = 0;
+                        }
+                    }
+                }
+            }
+        }
+
+        Histogram::add_batch(local, batch, n_batch);
+    }
+    counts.merge();
+
+    return counts.to_vector();
+}
+
+static double shell_volume(int bin, double bin_size) {
+    double r_lo = bin * bin_size;
+    double r_hi = r_lo + bin_size;
+    return 4.0 / 3.0 * M_PI * (r_hi * r_hi * r_hi - r_lo * r_lo * r_lo);
+}
+
+template <class Shape>
+void compute_rdf_cell_list(const std::vector<double>& positions, const Box<Shape>& box,
+                           std::vector<double>& rdf, double bin_size, int num_bins) {
+    size_t n_particles = positions.size() / 3;
+    std::vector<double> counts = cell_list_pair_counts(positions, nullptr, 1, box, bin_size, num_bins);
+
+    // g(r) = 2 * pair counts / (N * rho * shell volume)
+    double density = n_particles / box.volume();
+    rdf.assign(num_bins, 0.0);
+    for (int b = 0; b < num_bins; ++b) {
+        rdf[b] = 2.0 * counts[b] / (n_particles * density * shell_volume(b, bin_size));
+    }
+}
+
+// g_ab(r) = pairs_ab / (N_a * N_b / V * shell), pairs of like types count twice
+static void normalize_partials(const std::vector<double>& counts, const std::vector<int>& types, int n_types,
+                               double volume, std::vector<std::vector<double>>& rdfs, double bin_size, int num_bins) {
+    std::vector<double> n_of_type(n_types, 0.0);
+    for (int t : types) n_of_type[t] += 1.0;
+
+    rdfs.assign(n_types * (n_types + 1) / 2, std::vector<double>(num_bins, 0.0));
+    for (int a = 0; a < n_types; ++a) {
+        for (int b = a; b < n_types; ++b) {
+            int pair = rdf_pair_index(a, b, n_types);
+            double ideal = n_of_type[a] * n_of_type[b] / volume;
+            if (ideal == 0.0) continue;
+
+            double weight = (a == b) ? 2.0 : 1.0;
+            for (int bin = 0; bin < num_bins; ++bin) {
+                rdfs[pair][bin] = weight * counts[pair * num_bins + bin] / (ideal * shell_volume(bin, bin_size));
+            }
+        }
+    }
+}
+
+template <class Shape>
+void compute_partial_rdfs_cell_list(const std::vector<double>& positions, const std::vector<int>& types, int n_types,
+                                    const Box<Shape>& box,
+                                    std::vector<std::vector<double>>& rdfs, double bin_size, int num_bins) {
+    if (types.size() != positions.size() / 3) {
+        throw std::runtime_error("compute_partial_rdfs_cell_list: one type index per particle is required");
+    }
+
+    std::vector<double> counts = cell_list_pair_counts(positions, types.data(), n_types, box, bin_size, num_bins);
+    normalize_partials(counts, types, n_types, box.volume(), rdfs, bin_size, num_bins);
+}
+
+template <class Shape>
+void compute_partial_rdfs_neighbor_list(const std::vector<double>& positions, const std::vector<int>& types, int n_types,
+                                        const Box<Shape>& box, const NeighborList& list,
+                                        std::vector<std::vector<double>>& rdfs, double bin_size, int num_bins) {
+    if (types.size() != positions.size() / 3) {
+        throw std::runtime_error("compute_partial_rdfs_neighbor_list: one type index per particle is required");
+    }
+
+    std::vector<double> counts = neighbor_list_pair_counts(positions, types.data(), n_types, box, list, bin_size, num_bins);
+    normalize_partials(counts, types, n_types, box.volume(), rdfs, bin_size, num_bins);
+}
+
+// One instantiation per cell shape, chosen by the caller via with_box()
+#define INSTANTIATE_RDF(Shape)                                                                                           \
+    template void compute_rdf_cell_list(const std::vector<double>&, const Box<Shape>&, std::vector<double>&, double, int); \
+    template void compute_partial_rdfs_cell_list(const std::vector<double>&, const std::vector<int>&, int,               \
+                                                 const Box<Shape>&, std::vector<std::vector<double>>&, double, int);    \
+    template void compute_partial_rdfs_neighbor_list(const std::vector<double>&, const std::vector<int>&, int,           \
+                                                     const Box<Shape>&, const NeighborList&,                            \
+                                                     std::vector<std::vector<double>>&, double, int);
+
+INSTANTIATE_RDF(Orthorhombic)
+INSTANTIATE_RDF(Triclinic)
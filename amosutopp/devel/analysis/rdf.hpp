@@ -1,9 +1,36 @@
 #ifndef RDF_HPP
 #define RDF_HPP
 
+#include "box.hpp"
+#include "neighbor_list.hpp"
 #include <vector>
 
 void compute_rdf_cpu(const std::vector<double>& positions, std::vector<double>& rdf, double bin_size, int num_bins);
 void compute_rdf_gpu(const std::vector<double>& positions, std::vector<double>& rdf, double bin_size, int num_bins);
 
+// Linked-cell RDF in a periodic box (Box<Orthorhombic> or Box<Triclinic>):
+// only pairs closer than r_max = bin_size * num_bins are visited (minimum
+// image), threaded over cells. `rdf` receives g(r) normalised with the box volume.
+template <class Shape>
+void compute_rdf_cell_list(const std::vector<double>& positions, const Box<Shape>& box,
+                           std::vector<double>& rdf, double bin_size, int num_bins);
+
+// Index of the type pair (a, b) in the packed upper triangle of n_types types
+int rdf_pair_index(int a, int b, int n_types);
+
+// Every partial g_ab(r), a <= b, from a single linked-cell sweep. `types`
+// holds a type index in [0, n_types) per particle; `rdfs` receives the
+// n_types * (n_types + 1) / 2 partials ordered by rdf_pair_index().
+template <class Shape>
+void compute_partial_rdfs_cell_list(const std::vector<double>& positions, const std::vector<int>& types, int n_types,
+                                    const Box<Shape>& box,
+                                    std::vector<std::vector<double>>& rdfs, double bin_size, int num_bins);
+
+// Same partials, reading the pairs from an up-to-date half neighbour list
+// (cutoff >= r_max) instead of sweeping the cells again
+template <class Shape>
+void compute_partial_rdfs_neighbor_list(const std::vector<double>& positions, const std::vector<int>& types, int n_types,
+                                        const Box<Shape>& box, const NeighborList& list,
+                                        std::vector<std::vector<double>>& rdfs, double bin_size, int num_bins);
+
 #endif // RDF_HPP
\ No newline at end of file
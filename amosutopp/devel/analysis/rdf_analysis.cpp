@@ -1,7 +1,92 @@
 #include "rdf_analysis.hpp"
+#include "rdf.hpp"
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
+
+RDFAnalysis::RDFAnalysis(double bin_size, int num_bins, double skin)
+    : bin_size(bin_size), num_bins(num_bins), n_frames(0), neighbor_list(bin_size * num_bins, skin) {}
+
+void RDFAnalysis::fit_range(double min_width) {
+    // Pairs are counted up to r_max + skin under the minimum image, which
+    // only holds below half the box width
+    double limit = 0.5 * min_width - neighbor_list.skin();
+    if (bin_size * num_bins <= limit) return;
+
+    int fitting = static_cast<int>(std::floor(limit / bin_size));
+    if (fitting < 1) {
+        throw std::runtime_error("RDFAnalysis: box too small for the bin size and neighbour list skin");
+    }
+    std::cerr << "Warning: RDF range " << bin_size * num_bins << " reduced to " << bin_size * fitting
+              << " (half the box width minus the skin)" << std::endl;
+    num_bins = fitting;
+    neighbor_list = NeighborList(bin_size * num_bins, neighbor_list.skin());
+}
 
 void RDFAnalysis::analyze_frame(const chemfiles::Frame& frame, size_t frame_number) {
-    std::cout << "Performing RDF analysis on a frame." << std::endl;
-    // RDF analysis logic here
-}
\ No newline at end of file
+    // Type indices from the topology, built on the first frame
+    if (types.empty()) {
+        const auto& topology = frame.topology();
+        types.resize(topology.size());
+        for (size_t i = 0; i < topology.size(); ++i) {
+            const auto& type = topology[i].type();
+            size_t t = 0;
+            while (t < names.size() && names[t] != type) ++t;
+            if (t == names.size()) names.push_back(type);
+            types[i] = static_cast<int>(t);
+        }
+
+        fractions.assign(names.size(), 0.0);
+        for (int t : types) fractions[t] += 1.0 / types.size();
+    }
+
+    auto frame_positions = frame.positions();
+    positions.resize(3 * frame.size());
+    for (size_t i = 0; i < frame.size(); ++i) {
+        positions[3 * i + 0] = frame_positions[i][0];
+        positions[3 * i + 1] = frame_positions[i][1];
+        positions[3 * i + 2] = frame_positions[i][2];
+    }
+
+    // Shape dispatched once per frame, the pair kernels are specialised for it
+    std::vector<std::vector<double>> rdfs;
+    with_box(frame.cell(), [&](const auto& box) {
+        if (partial_sum.empty()) fit_range(box.min_width());
+        neighbor_list.update(positions, box);
+        compute_partial_rdfs_neighbor_list(positions, types, static_cast<int>(names.size()),
+                                           box, neighbor_list, rdfs, bin_size, num_bins);
+    });
+
+    if (partial_sum.empty()) {
+        partial_sum.assign(rdfs.size(), std::vector<double>(num_bins, 0.0));
+    }
+    for (size_t p = 0; p < rdfs.size(); ++p) {
+        for (int b = 0; b < num_bins; ++b) partial_sum[p][b] += rdfs[p][b];
+    }
+    n_frames++;
+}
+
+std::vector<std::vector<double>> RDFAnalysis::partial_result() const {
+    std::vector<std::vector<double>> rdfs(partial_sum);
+    if (n_frames > 0) {
+        for (auto& rdf : rdfs) {
+            for (auto& g : rdf) g /= n_frames;
+        }
+    }
+    return rdfs;
+}
+
+std::vector<double> RDFAnalysis::result() const {
+    // g(r) = sum_ab x_a x_b g_ab(r), unlike pairs appearing twice
+    std::vector<double> rdf(num_bins, 0.0);
+    auto rdfs = partial_result();
+    int n_types = static_cast<int>(names.size());
+    for (int a = 0; a < n_types; ++a) {
+        for (int b = a; b < n_types; ++b) {
+            double weight = (a == b ? 1.0 : 2.0) * fractions[a] * fractions[b];
+            const auto& g_ab = rdfs[rdf_pair_index(a, b, n_types)];
+            for (int bin = 0; bin < num_bins; ++bin) rdf[bin] += weight * g_ab[bin];
+        }
+    }
+    return rdf;
+}
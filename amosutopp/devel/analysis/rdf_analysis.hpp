@@ -2,10 +2,38 @@
 #define RDF_ANALYSIS_HPP
 
 #include "analysis.hpp"
+#include "neighbor_list.hpp"
+#include <string>
+#include <vector>
 
+// g(r) up to r_max = bin_size * num_bins. r_max + skin must stay below half
+// the smallest box width; on the first frame, num_bins is cut down to fit if
+// needed (with a warning), so the defaults also work on small boxes.
 class RDFAnalysis : public Analysis {
 public:
+    RDFAnalysis(double bin_size = 0.05, int num_bins = 200, double skin = 0.5);
+
     void analyze_frame(const chemfiles::Frame& frame, size_t frame_number) override;
+
+    // Total g(r) averaged over the frames analyzed so far
+    std::vector<double> result() const;
+
+    // Partial g_ab(r), packed by rdf_pair_index() over type_names()
+    std::vector<std::vector<double>> partial_result() const;
+    const std::vector<std::string>& type_names() const { return names; }
+
+private:
+    void fit_range(double min_width);  // shrinks num_bins to fit the box
+
+    double bin_size;
+    int num_bins;
+    size_t n_frames;
+    std::vector<std::vector<double>> partial_sum;
+    std::vector<double> fractions;      // mole fraction of every type
+    std::vector<std::string> names;     // atom type of every type index
+    std::vector<int> types;             // type index of every atom
+    std::vector<double> positions;      // reused flat xyz buffer
+    NeighborList neighbor_list;         // rebuilt only when atoms moved more than skin / 2
 };
 
-#endif // RDF_ANALYSIS_HPP
\ No newline at end of file
+#endif // RDF_ANALYSIS_HPP
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <chemfiles.hpp>
+#include "collective_dcd_reader.hpp"
+#include "topology_broadcast.hpp"
 #include </opt/homebrew/Cellar/open-mpi/5.0.3_1/include/mpi.h>
 
 int main(int argc, char** argv) {
@@ -15,29 +17,32 @@ int main(int argc, char** argv) {
     int world_rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
 
-    // Open the static.dcd file (trajectory)
-    chemfiles::Trajectory trajectory("static.dcd");
-    trajectory.set_topology("structure.data", "LAMMPS Data");
-    auto topology = trajectory.read().topology();
-    auto atom_mass = topology[0].mass();
+    // Topology parsed by the master process only and shared through node memory
+    TopologyCache topology = broadcast_topology("structure.data", MPI_COMM_WORLD);
+    auto atom_mass = topology.masses()[0];
 
-    // Get the total number of frames (do it only on one process and broadcast it)
-    size_t n_frames = trajectory.nsteps();
-    MPI_Bcast(&n_frames, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    {
+        // Open the static.dcd file (trajectory); the header is parsed by the
+        // master process only, and every process gets a contiguous range of frames
+        CollectiveDCDReader trajectory("static.dcd", MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            std::cout << "Frames: " << trajectory.n_frames() << ", processes: " << world_size << std::endl;
+        }
 
-    // Calculate the frames each process should handle
-    size_t frames_per_process = n_frames / world_size;
-    size_t start_frame = world_rank * frames_per_process;
-    size_t end_frame = (world_rank == world_size - 1) ? n_frames : start_frame + frames_per_process;
+        // Each process reads its assigned frames a block at a time, all
+        // processes together (collective MPI-IO), until every one is done
+        while (trajectory.next_block()) {
+            for (size_t i = trajectory.block_begin(); i < trajectory.block_begin() + trajectory.block_size(); ++i) {
 
-    // Each process processes its assigned frames
-    for (size_t i = start_frame; i < end_frame; ++i) {
+                // Coordinates of the i-th frame
+                auto x = trajectory.x(i);
+                auto y = trajectory.y(i);
+                auto z = trajectory.z(i);
 
-        // Read the i-th frame
-        auto frame = trajectory.read_step(i);
-
-        // Perform analysis
+                // Perform analysis
 
+            }
+        }
     }
 
     // Finalize MPI
@@ -1,3 +1,4 @@
 # g++-14 dcd_only.cpp -o dcd_only -I/usr/local/include -lchemfiles -L/usr/local/lib
 g++-14 dcd_data.cpp -o dcd_data -I/usr/local/include -lchemfiles -L/usr/local/lib
-# g++-14 dcd_data_set_topology.cpp -o dcd_data_set_topology -I/usr/local/include -lchemfiles -L/usr/local/lib
\ No newline at end of file
+# g++-14 dcd_data_set_topology.cpp -o dcd_data_set_topology -I/usr/local/include -lchemfiles -L/usr/local/lib
+# g++-14 -std=c++20 -O3 dcd_native.cpp ../dcd_reader.cpp -o dcd_native
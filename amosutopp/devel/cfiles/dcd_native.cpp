@@ -0,0 +1,29 @@
+#include <chrono>
+#include <iostream>
+#include "../dcd_reader.hpp"
+
+// Same loop as dcd_only, through the mapped float views instead of chemfiles frames
+int main() {
+    size_t n_iters = 1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double checksum = 0.0;
+    for (size_t n = 0; n < n_iters; n++) {
+        DCDReader file("static.dcd");
+
+        for (size_t i = 0; i < file.n_frames(); i++) {
+            auto x = file.x(i);
+            auto y = file.y(i);
+            auto z = file.z(i);
+            checksum += x[0] + y[0] + z[0];
+        }
+    }
+
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    auto duration_ms = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+    std::cout << "Average time to read: " << duration_ms / n_iters / 1e3 << " ms (checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
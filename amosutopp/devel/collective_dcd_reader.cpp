@@ -0,0 +1,107 @@
+#include "collective_dcd_reader.hpp"
+#include "dcd_reader.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+
+CollectiveDCDReader::CollectiveDCDReader(const std::string& path, MPI_Comm comm, size_t frames_per_read)
+    : frames_per_read(std::max<size_t>(frames_per_read, 1)) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Header parsed once; layout[0] == 0 tells the other ranks it failed
+    uint64_t layout[6] = {0, 0, 0, 0, 0, 0};
+    std::string error;
+    if (rank == 0) {
+        try {
+            DCDReader header(path);
+            layout[0] = 1;
+            layout[1] = header.header_bytes();
+            layout[2] = header.frame_bytes();
+            layout[3] = header.n_frames();
+            layout[4] = header.n_atoms();
+            layout[5] = header.has_cell();
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+    }
+    MPI_Bcast(layout, 6, MPI_UINT64_T, 0, comm);
+    if (layout[0] == 0) {
+        throw std::runtime_error(rank == 0 ? error : "CollectiveDCDReader: rank 0 could not read " + path);
+    }
+    header_size = layout[1];
+    frame_size = layout[2];
+    frames = layout[3];
+    atoms = layout[4];
+    has_cell = layout[5] != 0;
+    if (frame_size > static_cast<size_t>(INT_MAX)) {
+        throw std::runtime_error("CollectiveDCDReader: frames larger than 2 GiB are not supported");
+    }
+
+    // Same contiguous split as Parallel::distribute_frames
+    size_t per_rank = frames / size, remainder = frames % size;
+    first = rank * per_rank + std::min<size_t>(rank, remainder);
+    last = first + per_rank + (static_cast<size_t>(rank) < remainder ? 1 : 0);
+    current = first;
+
+    size_t my_blocks = (last - first + this->frames_per_read - 1) / this->frames_per_read;
+    unsigned long long local = my_blocks, global = 0;
+    MPI_Allreduce(&local, &global, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, comm);
+    max_blocks = global;
+
+    // Collective buffering hints; implementations ignore the ones they do not know
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "romio_cb_read", "enable");
+    MPI_Info_set(info, "cb_buffer_size", "16777216");
+    int status = MPI_File_open(comm, path.c_str(), MPI_MODE_RDONLY, info, &file);
+    MPI_Info_free(&info);
+    if (status != MPI_SUCCESS) throw std::runtime_error("CollectiveDCDReader: MPI_File_open failed for " + path);
+
+    MPI_Type_contiguous(static_cast<int>(frame_size), MPI_BYTE, &frame_type);
+    MPI_Type_commit(&frame_type);
+    buffer.resize(this->frames_per_read * frame_size);
+}
+
+CollectiveDCDReader::~CollectiveDCDReader() {
+    MPI_Type_free(&frame_type);
+    MPI_File_close(&file);
+}
+
+bool CollectiveDCDReader::next_block() {
+    if (blocks_done == max_blocks) return false;
+
+    // Ranks past their last frame still take part, with an empty read
+    current += current_size;
+    current_size = std::min(frames_per_read, last - current);
+    MPI_Offset offset = static_cast<MPI_Offset>(header_size + current * frame_size);
+    MPI_Status status;
+    MPI_File_read_at_all(file, offset, buffer.data(), static_cast<int>(current_size), frame_type, &status);
+    int count = 0;
+    MPI_Get_count(&status, frame_type, &count);
+    if (static_cast<size_t>(count) != current_size) {
+        throw std::runtime_error("CollectiveDCDReader: short read at frame " + std::to_string(current));
+    }
+
+    blocks_done++;
+    return true;
+}
+
+const unsigned char* CollectiveDCDReader::frame_data(size_t frame) const {
+    if (frame < current || frame >= current + current_size) {
+        throw std::runtime_error("CollectiveDCDReader: frame " + std::to_string(frame) + " is not in the current block");
+    }
+    return buffer.data() + (frame - current) * frame_size;
+}
+
+std::span<const float> CollectiveDCDReader::coordinates(size_t frame, int d) const {
+    const unsigned char* p = frame_data(frame) + (has_cell ? 56 : 0) + d * (8 + 4 * atoms) + 4;
+    return {reinterpret_cast<const float*>(p), atoms};
+}
+
+std::array<double, 6> CollectiveDCDReader::cell(size_t frame) const {
+    if (!has_cell) return {};
+    return DCDReader::decode_cell(frame_data(frame));
+}
@@ -0,0 +1,61 @@
+#ifndef COLLECTIVE_DCD_READER_HPP
+#define COLLECTIVE_DCD_READER_HPP
+
+#include <mpi.h>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+// DCD reader for MPI jobs: rank 0 parses the header and broadcasts the frame
+// layout, then every rank reads its own contiguous range of frames by byte
+// offset with MPI_File_read_at_all, a block of frames at a time, so MPI-IO
+// can aggregate the requests (collective buffering) instead of every rank
+// seeking through the file on its own.
+//
+// next_block() is collective: all ranks of the communicator call it until it
+// returns false, including ranks that have run out of frames.
+class CollectiveDCDReader {
+public:
+    CollectiveDCDReader(const std::string& path, MPI_Comm comm = MPI_COMM_WORLD, size_t frames_per_read = 16);
+    ~CollectiveDCDReader();
+
+    CollectiveDCDReader(const CollectiveDCDReader&) = delete;
+    CollectiveDCDReader& operator=(const CollectiveDCDReader&) = delete;
+
+    size_t n_frames() const { return frames; }
+    size_t n_atoms() const { return atoms; }
+
+    // Frames [begin, end) of this rank, split as Parallel::distribute_frames does
+    size_t begin() const { return first; }
+    size_t end() const { return last; }
+
+    // Reads the next block of this rank's frames; frames
+    // [block_begin(), block_begin() + block_size()) are then available
+    bool next_block();
+    size_t block_begin() const { return current; }
+    size_t block_size() const { return current_size; }
+
+    // Views into the block buffer, valid until the next call to next_block()
+    std::span<const float> x(size_t frame) const { return coordinates(frame, 0); }
+    std::span<const float> y(size_t frame) const { return coordinates(frame, 1); }
+    std::span<const float> z(size_t frame) const { return coordinates(frame, 2); }
+    std::array<double, 6> cell(size_t frame) const;  // zero without a unit cell
+
+private:
+    std::span<const float> coordinates(size_t frame, int d) const;
+    const unsigned char* frame_data(size_t frame) const;
+
+    MPI_File file;
+    MPI_Datatype frame_type;
+    size_t header_size, frame_size, frames, atoms;
+    bool has_cell;
+    size_t first, last;
+    size_t frames_per_read;
+    size_t blocks_done = 0, max_blocks = 0;     // max over all ranks, so every rank joins every read
+    size_t current = 0, current_size = 0;
+    std::vector<unsigned char> buffer;
+};
+
+#endif // COLLECTIVE_DCD_READER_HPP
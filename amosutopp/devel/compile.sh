@@ -1,16 +1,31 @@
-# g++-14 read_trj.cpp -o read_trj -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
+# g++-14 -std=c++20 -fopenmp read_trj_mpi.cpp topology_broadcast.cpp topology_cache.cpp trajectory_handler.cpp dcd_reader.cpp frame_index.cpp text_frame_parser.cpp -o read_trj_mpi -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
+# g++-14 -std=c++20 analysis_mpi.cpp collective_dcd_reader.cpp dcd_reader.cpp topology_broadcast.cpp topology_cache.cpp -o analysis_mpi -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
+# g++-14 -std=c++20 -fopenmp read_trj.cpp trajectory_handler.cpp dcd_reader.cpp frame_index.cpp topology_cache.cpp text_frame_parser.cpp -o read_trj -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
 
 
 # Compile the individual cpp files
 g++-14 -c mpi_handler.cpp -o mpi_handler.o -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
-g++-14 -c trajectory_handler.cpp -o trajectory_handler.o -I/usr/local/include -lchemfiles -L/usr/local/lib
+g++-14 -std=c++20 -O3 -c dcd_reader.cpp -o dcd_reader.o
+g++-14 -std=c++20 -fopenmp -O3 -c frame_index.cpp -o frame_index.o
+g++-14 -std=c++20 -O3 -c frame_selection.cpp -o frame_selection.o
+g++-14 -std=c++20 -O3 -c text_frame_parser.cpp -o text_frame_parser.o
+g++-14 -std=c++20 -fopenmp -O3 -c trajectory_tensor.cpp -o trajectory_tensor.o -I/usr/local/include
+g++-14 -std=c++20 -O3 -c topology_cache.cpp -o topology_cache.o -I/usr/local/include
+g++-14 -std=c++20 -c topology_broadcast.cpp -o topology_broadcast.o -I/usr/local/include -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
+g++-14 -std=c++20 -c trajectory_handler.cpp -o trajectory_handler.o -I/usr/local/include -lchemfiles -L/usr/local/lib
+g++-14 -std=c++20 -pthread -c frame_prefetcher.cpp -o frame_prefetcher.o -I/usr/local/include
+g++-14 -std=c++20 -O3 -c frame_cache.cpp -o frame_cache.o -I/usr/local/include
 cd analysis
-g++-14 -c perform_analysis.cpp -o perform_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib
+g++-14 -std=c++20 -c perform_analysis.cpp -o perform_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib
 g++-14 -c rdf_analysis.cpp -o rdf_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib
+g++-14 -fopenmp -O3 -march=native -c rdf.cpp -o rdf.o
+g++-14 -fopenmp -O3 -march=native -c histogram.cpp -o histogram.o
+g++-14 -fopenmp -O3 -march=native -c cell_list.cpp -o cell_list.o
+g++-14 -fopenmp -O3 -march=native -c neighbor_list.cpp -o neighbor_list.o
 g++-14 -c msd_analysis.cpp -o msd_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib
 g++-14 -c rmsd_analysis.cpp -o rmsd_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include
 cd ..
-g++-14 -c main.cpp -o main.o -I/usr/local/include -lchemfiles -L/usr/local/lib
+g++-14 -std=c++20 -c main.cpp -o main.o -I/usr/local/include -I/opt/homebrew/Cellar/open-mpi/5.0.3_1/include -lchemfiles -L/usr/local/lib
 
 # Link all the object files into an executable
-g++-14 -o analysis_test main.o mpi_handler.o trajectory_handler.o analysis/perform_analysis.o analysis/rdf_analysis.o analysis/msd_analysis.o analysis/rmsd_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebr
\ No newline at end of file
+g++-14 -fopenmp -pthread -o analysis_test main.o mpi_handler.o trajectory_handler.o dcd_reader.o frame_index.o frame_selection.o text_frame_parser.o trajectory_tensor.o topology_cache.o topology_broadcast.o frame_prefetcher.o frame_cache.o analysis/perform_analysis.o analysis/rdf_analysis.o analysis/rdf.o analysis/histogram.o analysis/cell_list.o analysis/neighbor_list.o analysis/msd_analysis.o analysis/rmsd_analysis.o -I/usr/local/include -lchemfiles -L/usr/local/lib -L/opt/homebrew/Cellar/open-mpi/5.0.3_1/lib -lmpi -I/opt/homebr
\ No newline at end of file
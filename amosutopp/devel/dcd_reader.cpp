@@ -0,0 +1,131 @@
+#include "dcd_reader.hpp"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+int32_t read_int(const unsigned char* p) {
+    int32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Size of a Fortran record (payload plus both markers) starting at p, after
+// checking that the markers agree and the record fits in the file
+size_t record_size(const unsigned char* begin, size_t offset, size_t file_size) {
+    if (offset + 4 > file_size) throw std::runtime_error("DCDReader: truncated header");
+    int32_t length = read_int(begin + offset);
+    if (length < 0 || offset + 8 + static_cast<size_t>(length) > file_size ||
+        read_int(begin + offset + 4 + length) != length) {
+        throw std::runtime_error("DCDReader: bad record marker");
+    }
+    return 8 + static_cast<size_t>(length);
+}
+
+}
+
+DCDReader::DCDReader(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("DCDReader: cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 92) {
+        close(fd);
+        throw std::runtime_error("DCDReader: " + path + " is too small to be a DCD file");
+    }
+    file_size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) throw std::runtime_error("DCDReader: cannot map " + path);
+    data = static_cast<const unsigned char*>(map);
+    madvise(map, file_size, MADV_SEQUENTIAL);
+
+    try {
+        // Record 1: "CORD" and 20 control integers
+        if (read_int(data) != 84 || std::memcmp(data + 4, "CORD", 4) != 0 || read_int(data + 88) != 84) {
+            throw std::runtime_error("DCDReader: " + path + " is not a little-endian DCD file");
+        }
+        int32_t control[20];
+        std::memcpy(control, data + 8, sizeof(control));
+        bool charmm = control[19] != 0;
+        if (control[8] != 0) {
+            throw std::runtime_error("DCDReader: fixed atoms are not supported");
+        }
+        cell_block = charmm && control[10] != 0;
+        bool fourth_dimension = charmm && control[11] != 0;
+
+        // Record 2: titles, record 3: number of atoms
+        size_t offset = 92;
+        offset += record_size(data, offset, file_size);
+        if (record_size(data, offset, file_size) != 12) throw std::runtime_error("DCDReader: bad atom count record");
+        atoms = static_cast<size_t>(read_int(data + offset + 4));
+        header_size = offset + 12;
+
+        size_t coordinate_block = 8 + 4 * atoms;
+        frame_size = (cell_block ? 56 : 0) + (fourth_dimension ? 4 : 3) * coordinate_block;
+        frames = (file_size - header_size) / frame_size;  // a truncated last frame is ignored
+
+        // Fixed frame size assumed from here on, checked on the first frame
+        if (frames > 0) {
+            size_t check = header_size;
+            if (cell_block) check += record_size(data, check, file_size);
+            for (int d = 0; d < 3; ++d) {
+                if (record_size(data, check, file_size) != coordinate_block) {
+                    throw std::runtime_error("DCDReader: unexpected coordinate block size");
+                }
+                check += coordinate_block;
+            }
+        }
+    } catch (...) {
+        munmap(const_cast<unsigned char*>(data), file_size);
+        throw;
+    }
+}
+
+DCDReader::~DCDReader() {
+    munmap(const_cast<unsigned char*>(data), file_size);
+}
+
+const unsigned char* DCDReader::frame_data(size_t frame) const {
+    if (frame >= frames) throw std::runtime_error("DCDReader: frame index out of range");
+    return data + header_size + frame * frame_size;
+}
+
+void DCDReader::advise_sparse() const {
+    madvise(const_cast<unsigned char*>(data), file_size, MADV_RANDOM);
+}
+
+std::span<const float> DCDReader::block(size_t frame, int d) const {
+    const unsigned char* p = frame_data(frame) + (cell_block ? 56 : 0) + d * (8 + 4 * atoms) + 4;
+    return {reinterpret_cast<const float*>(p), atoms};
+}
+
+std::array<double, 6> DCDReader::cell(size_t frame) const {
+    if (!cell_block) return {};
+    return decode_cell(frame_data(frame));
+}
+
+std::array<double, 6> DCDReader::decode_cell(const unsigned char* frame) {
+    // Stored as a, gamma, b, beta, alpha, c; the angles are cosines in files
+    // from CHARMM >= 25 and LAMMPS, degrees otherwise
+    std::array<double, 6> result{};
+    double v[6];
+    std::memcpy(v, frame + 4, sizeof(v));
+    double angles[3] = {v[4], v[3], v[1]};
+    bool cosines = std::fabs(angles[0]) <= 1.0 && std::fabs(angles[1]) <= 1.0 && std::fabs(angles[2]) <= 1.0;
+    result[0] = v[0];
+    result[1] = v[2];
+    result[2] = v[5];
+    for (int k = 0; k < 3; ++k) {
+        result[3 + k] = cosines ? 90.0 - std::asin(angles[k]) * 180.0 / M_PI : angles[k];
+    }
+    return result;
+}
+
+bool DCDReader::can_read(const std::string& path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".dcd") == 0;
+}
@@ -0,0 +1,67 @@
+#ifndef DCD_READER_HPP
+#define DCD_READER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Native reader for CHARMM/LAMMPS DCD files. The file is mapped once and the
+// header parsed once; every frame then has a fixed size, so the x, y and z
+// blocks of frame i are handed out as float views straight into the mapping,
+// with no copy or conversion to double. Needs C++20 (std::span).
+//
+// Only little-endian files with 32-bit record markers and no fixed atoms are
+// supported (what LAMMPS writes); anything else throws, and the caller falls
+// back to chemfiles.
+class DCDReader {
+public:
+    explicit DCDReader(const std::string& path);
+    ~DCDReader();
+
+    DCDReader(const DCDReader&) = delete;
+    DCDReader& operator=(const DCDReader&) = delete;
+
+    size_t n_frames() const { return frames; }
+    size_t n_atoms() const { return atoms; }
+    bool has_cell() const { return cell_block; }
+
+    std::span<const float> x(size_t frame) const { return block(frame, 0); }
+    std::span<const float> y(size_t frame) const { return block(frame, 1); }
+    std::span<const float> z(size_t frame) const { return block(frame, 2); }
+
+    // Cell lengths and angles in degrees (a, b, c, alpha, beta, gamma), zero
+    // if the file has no unit cell
+    std::array<double, 6> cell(size_t frame) const;
+
+    // Byte layout, for readers that fetch frames themselves
+    size_t header_bytes() const { return header_size; }
+    size_t frame_bytes() const { return frame_size; }
+
+    // Switches the mapping from sequential read-ahead to random access, for
+    // callers that touch a few atoms or frames only, so the kernel reads the
+    // pages they use rather than the whole file
+    void advise_sparse() const;
+
+    // True for a .dcd file this reader can map
+    static bool can_read(const std::string& path);
+
+    // Cell of a frame whose bytes were fetched elsewhere, `frame` pointing
+    // at its start (the unit cell record)
+    static std::array<double, 6> decode_cell(const unsigned char* frame);
+
+private:
+    std::span<const float> block(size_t frame, int d) const;
+    const unsigned char* frame_data(size_t frame) const;
+
+    const unsigned char* data = nullptr;
+    size_t file_size = 0;
+    size_t header_size = 0;
+    size_t frame_size = 0;
+    size_t frames = 0;
+    size_t atoms = 0;
+    bool cell_block = false;
+};
+
+#endif // DCD_READER_HPP
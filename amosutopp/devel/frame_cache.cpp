@@ -0,0 +1,53 @@
+#include "frame_cache.hpp"
+#include <algorithm>
+#include <utility>
+
+void FrameCache::set_budget(size_t budget_bytes) {
+    budget = budget_bytes;
+    std::vector<chemfiles::Vector3D> storage;
+    while (used > budget) evict_last(storage);
+}
+
+void FrameCache::evict_last(std::vector<chemfiles::Vector3D>& storage) {
+    Entry& last = order.back();
+    used -= bytes(last.positions.size());
+    entries.erase(last.index);
+    storage = std::move(last.positions);
+    order.pop_back();
+}
+
+bool FrameCache::lookup(size_t i, FrameBuffer& buffer) {
+    auto found = entries.find(i);
+    if (found == entries.end()) return false;
+
+    order.splice(order.begin(), order, found->second);
+    const Entry& entry = *found->second;
+    buffer.attach(entry.topology, entry.positions.size());
+    auto positions = buffer.frame.positions();
+    std::copy(entry.positions.begin(), entry.positions.end(), positions.begin());
+    buffer.frame.set_cell(entry.cell);
+    buffer.frame.set_step(i);
+    buffer.index = i;
+    return true;
+}
+
+void FrameCache::insert(const FrameBuffer& buffer) {
+    const auto& frame = buffer.frame;
+    size_t need = bytes(frame.size());
+    if (need > budget || !buffer.topology || entries.count(buffer.index)) return;  // decoded frames do not change
+
+    std::vector<chemfiles::Vector3D> storage;
+    while (used + need > budget) evict_last(storage);
+
+    auto positions = frame.positions();
+    storage.assign(positions.begin(), positions.end());
+    order.push_front(Entry{buffer.index, std::move(storage), frame.cell(), buffer.topology});
+    entries[buffer.index] = order.begin();
+    used += need;
+}
+
+void FrameCache::clear() {
+    order.clear();
+    entries.clear();
+    used = 0;
+}
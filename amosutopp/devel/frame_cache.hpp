@@ -0,0 +1,51 @@
+#ifndef FRAME_CACHE_HPP
+#define FRAME_CACHE_HPP
+
+#include <chemfiles.hpp>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "trajectory_handler.hpp"
+
+// Decoded frames kept in memory up to a byte budget, keyed by frame index,
+// least recently used evicted first. Only the positions and the cell are
+// kept (the topology is the handler's, attached to the buffer on a hit), so
+// a frame costs about 24 bytes per atom. Storage of evicted frames is
+// reused for the next insertion. Not thread-safe.
+class FrameCache {
+public:
+    explicit FrameCache(size_t budget_bytes = 0) : budget(budget_bytes) {}
+
+    // Evicts frames until the cache fits; 0 disables it
+    void set_budget(size_t budget_bytes);
+    size_t budget_bytes() const { return budget; }
+    size_t used_bytes() const { return used; }
+    size_t size() const { return entries.size(); }
+
+    // Frame i into `buffer` if it is cached, marking it recently used
+    bool lookup(size_t i, FrameBuffer& buffer);
+
+    // Copy of the frame in `buffer`; frames larger than the budget are not kept
+    void insert(const FrameBuffer& buffer);
+
+    void clear();
+
+private:
+    struct Entry {
+        size_t index;
+        std::vector<chemfiles::Vector3D> positions;
+        chemfiles::UnitCell cell;
+        std::shared_ptr<const chemfiles::Topology> topology;
+    };
+
+    static size_t bytes(size_t n_atoms) { return sizeof(Entry) + n_atoms * sizeof(chemfiles::Vector3D); }
+    void evict_last(std::vector<chemfiles::Vector3D>& storage);
+
+    size_t budget, used = 0;
+    std::list<Entry> order;  // most recently used first
+    std::unordered_map<size_t, std::list<Entry>::iterator> entries;
+};
+
+#endif // FRAME_CACHE_HPP
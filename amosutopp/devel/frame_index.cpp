@@ -0,0 +1,224 @@
+#include "frame_index.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t npos = static_cast<size_t>(-1);
+constexpr char magic[8] = {'F', 'R', 'A', 'M', 'E', 'I', 'D', 'X'};
+constexpr uint64_t version = 1;
+
+struct Text {
+    const char* data;
+    size_t size;    // up to the end of the last non-blank line
+    bool xyz;       // XYZ, otherwise LAMMPS dump
+
+    size_t next_line(size_t p) const {
+        const void* newline = std::memchr(data + p, '\n', size - p);
+        return newline ? static_cast<const char*>(newline) - data + 1 : size;
+    }
+
+    // Line holding nothing but a non-negative integer: an XYZ atom count
+    bool count_line(size_t p, size_t& count) const {
+        size_t end = next_line(p);
+        while (p < end && (data[p] == ' ' || data[p] == '\t')) ++p;
+        if (p == end || !std::isdigit(static_cast<unsigned char>(data[p]))) return false;
+        count = 0;
+        while (p < end && std::isdigit(static_cast<unsigned char>(data[p]))) count = 10 * count + (data[p++] - '0');
+        while (p < end && std::isspace(static_cast<unsigned char>(data[p]))) ++p;
+        return p == end;
+    }
+
+    bool lammps_header(size_t p) const {
+        return std::string_view(data + p, std::min<size_t>(size - p, 14)) == "ITEM: TIMESTEP";
+    }
+
+    // Start of the frame after the one starting at p, npos if p does not start a frame
+    size_t next_frame(size_t p) const {
+        if (xyz) {
+            size_t count;
+            if (!count_line(p, count)) return npos;
+            p = next_line(p);
+            for (size_t k = 0; k <= count; ++k) {  // comment line, then the atoms
+                if (p >= size) return npos;
+                p = next_line(p);
+            }
+            return p;
+        }
+        if (!lammps_header(p)) return npos;
+        std::string_view rest(data, size);
+        size_t q = rest.find("\nITEM: TIMESTEP", p);
+        return q == std::string_view::npos ? size : q + 1;
+    }
+
+    // First frame start at or after `from`, found by trying line starts. An XYZ
+    // candidate must be followed by a second well-formed frame (or the end)
+    size_t sync(size_t from) const {
+        size_t p = from == 0 ? 0 : next_line(from - 1);
+        for (; p < size; p = next_line(p)) {
+            size_t q = next_frame(p);
+            if (q == npos) continue;
+            if (!xyz || q >= size || next_frame(q) != npos) return p;
+        }
+        return size;
+    }
+};
+
+// Frames starting in [begin, end), walked from the first one found by sync()
+struct Chunk {
+    size_t begin, end;
+    std::vector<uint64_t> starts;
+    size_t handoff = npos;  // first frame start at or after `end`
+    bool ok = true;
+};
+
+void walk(const Text& text, size_t p, Chunk& chunk) {
+    while (p < chunk.end && p < text.size) {
+        chunk.starts.push_back(p);
+        p = text.next_frame(p);
+        if (p == npos) {
+            chunk.ok = false;
+            return;
+        }
+    }
+    chunk.handoff = p;
+}
+
+int64_t modification_time(const std::string& path) {
+    return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
+
+}
+
+std::string FrameIndex::format_of(const std::string& trajectory_file) {
+    std::string extension = std::filesystem::path(trajectory_file).extension().string();
+    if (extension == ".xyz") return "XYZ";
+    if (extension == ".lammpstrj" || extension == ".dump") return "LAMMPS";
+    return "";
+}
+
+FrameIndex FrameIndex::open(const std::string& trajectory_file, const std::string& format) {
+    std::string sidecar = trajectory_file + ".idx";
+    FrameIndex index;
+    if (index.load(sidecar) && index.file_size == std::filesystem::file_size(trajectory_file) &&
+        index.mtime == modification_time(trajectory_file)) {
+        return index;
+    }
+
+    index = build(trajectory_file, format);
+    index.save(sidecar);
+    return index;
+}
+
+FrameIndex FrameIndex::build(const std::string& trajectory_file, const std::string& format) {
+    if (format != "XYZ" && format != "LAMMPS") {
+        throw std::runtime_error("FrameIndex: no frame index for format '" + format + "'");
+    }
+
+    FrameIndex index;
+    index.file_size = std::filesystem::file_size(trajectory_file);
+    index.mtime = modification_time(trajectory_file);
+    if (index.file_size == 0) {
+        index.offsets = {0};
+        return index;
+    }
+
+    int fd = ::open(trajectory_file.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("FrameIndex: cannot open " + trajectory_file);
+    void* map = mmap(nullptr, index.file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) throw std::runtime_error("FrameIndex: cannot map " + trajectory_file);
+    madvise(map, index.file_size, MADV_SEQUENTIAL);
+
+    Text text{static_cast<const char*>(map), index.file_size, format == "XYZ"};
+    while (text.size > 0 && std::isspace(static_cast<unsigned char>(text.data[text.size - 1]))) --text.size;
+    const void* newline = std::memchr(text.data + text.size, '\n', index.file_size - text.size);
+    text.size = newline ? static_cast<const char*>(newline) - text.data + 1 : index.file_size;
+
+    // Each chunk resynchronises on its first frame header and walks frames
+    // until it passes its end; at least 1 MiB per chunk
+    size_t n_chunks = std::clamp<size_t>(text.size >> 20, 1, 4 * static_cast<size_t>(omp_get_max_threads()));
+    std::vector<Chunk> chunks(n_chunks);
+    for (size_t c = 0; c < n_chunks; ++c) {
+        chunks[c].begin = text.size * c / n_chunks;
+        chunks[c].end = text.size * (c + 1) / n_chunks;
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t c = 0; c < n_chunks; ++c) {
+        walk(text, c == 0 ? 0 : text.sync(chunks[c].begin), chunks[c]);
+    }
+
+    // Stitch: a chunk is trusted only if it starts exactly where the previous
+    // one handed off, otherwise (a false sync) it is walked again from there
+    size_t p = 0;
+    for (Chunk& chunk : chunks) {
+        if (p >= chunk.end) continue;  // a frame longer than the chunk
+        if (!chunk.ok || chunk.starts.empty() || chunk.starts.front() != p) {
+            chunk.starts.clear();
+            chunk.ok = true;
+            walk(text, p, chunk);
+            if (!chunk.ok) {
+                munmap(map, index.file_size);
+                throw std::runtime_error("FrameIndex: malformed " + format + " frame in " + trajectory_file);
+            }
+        }
+        index.offsets.insert(index.offsets.end(), chunk.starts.begin(), chunk.starts.end());
+        p = chunk.handoff;
+    }
+    index.offsets.push_back(text.size);
+
+    munmap(map, index.file_size);
+    return index;
+}
+
+bool FrameIndex::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char file_magic[8];
+    uint64_t file_version = 0, n_offsets = 0;
+    in.read(file_magic, sizeof(file_magic));
+    in.read(reinterpret_cast<char*>(&file_version), sizeof(file_version));
+    in.read(reinterpret_cast<char*>(&file_size), sizeof(file_size));
+    in.read(reinterpret_cast<char*>(&mtime), sizeof(mtime));
+    in.read(reinterpret_cast<char*>(&n_offsets), sizeof(n_offsets));
+    if (!in || std::memcmp(file_magic, magic, sizeof(magic)) != 0 || file_version != version || n_offsets == 0) {
+        return false;
+    }
+    offsets.resize(n_offsets);
+    in.read(reinterpret_cast<char*>(offsets.data()), n_offsets * sizeof(uint64_t));
+    return static_cast<bool>(in);
+}
+
+void FrameIndex::save(const std::string& path) const {
+    // Written aside and renamed, so concurrent ranks never see half an index;
+    // the thread id keeps handles opened by threads of one process apart
+    std::string tmp = path + ".tmp." + std::to_string(getpid()) + "." +
+                      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        uint64_t n_offsets = offsets.size();
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&file_size), sizeof(file_size));
+        out.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+        out.write(reinterpret_cast<const char*>(&n_offsets), sizeof(n_offsets));
+        out.write(reinterpret_cast<const char*>(offsets.data()), n_offsets * sizeof(uint64_t));
+        if (!out) {
+            out.close();
+            std::remove(tmp.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) std::remove(tmp.c_str());
+}
@@ -0,0 +1,37 @@
+#ifndef FRAME_INDEX_HPP
+#define FRAME_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte offset of every frame of a text trajectory (XYZ or LAMMPS dump), so
+// frame i can be read by seeking instead of scanning from the start. The
+// index is kept next to the trajectory in `<file>.idx` and trusted only while
+// the trajectory's size and modification time match the ones it records.
+class FrameIndex {
+public:
+    // Loads the sidecar if it is still valid, otherwise builds the index (in
+    // parallel) and tries to write the sidecar; a read-only directory only
+    // costs the rebuild next time
+    static FrameIndex open(const std::string& trajectory_file, const std::string& format);
+
+    // chemfiles format name ("XYZ", "LAMMPS") for the text formats the index
+    // understands, empty otherwise
+    static std::string format_of(const std::string& trajectory_file);
+
+    size_t n_frames() const { return offsets.size() - 1; }
+    uint64_t offset(size_t i) const { return offsets[i]; }
+    uint64_t size(size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+private:
+    static FrameIndex build(const std::string& trajectory_file, const std::string& format);
+    bool load(const std::string& path);
+    void save(const std::string& path) const;
+
+    std::vector<uint64_t> offsets;  // n_frames + 1, the last one is the end of the last frame
+    uint64_t file_size = 0;
+    int64_t mtime = 0;
+};
+
+#endif // FRAME_INDEX_HPP
@@ -0,0 +1,67 @@
+#include "frame_prefetcher.hpp"
+#include <stdexcept>
+
+FramePrefetcher::FramePrefetcher(TrajectoryHandler& trajectory_handler, size_t begin, size_t end, size_t depth,
+                                 size_t stride)
+    : trajectory_handler(trajectory_handler), begin(begin), stride(stride), slots(depth + 1) {
+    if (depth == 0) {
+        throw std::runtime_error("FramePrefetcher needs a depth of at least one frame");
+    }
+    if (stride == 0) {
+        throw std::runtime_error("FramePrefetcher needs a stride of at least one frame");
+    }
+    count = end > begin ? (end - begin + stride - 1) / stride : 0;
+    reader = std::thread(&FramePrefetcher::run, this);
+}
+
+FramePrefetcher::~FramePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    slot_free.notify_all();
+    reader.join();
+}
+
+void FramePrefetcher::run() {
+    try {
+        for (size_t n = 0; n < count; ++n) {
+            size_t i = begin + n * stride;
+            {
+                // Wait for a free slot; the one the consumer holds is not free
+                std::unique_lock<std::mutex> lock(mutex);
+                slot_free.wait(lock, [&] { return stopping || n - consumed < slots.size(); });
+                if (stopping) return;
+            }
+
+            // Decoded outside the lock, into a slot the consumer cannot see yet
+            trajectory_handler.read_into(i, slots[n % slots.size()]);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                produced = n + 1;
+            }
+            frame_ready.notify_one();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+    }
+    frame_ready.notify_one();
+}
+
+const FrameBuffer* FramePrefetcher::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    frame_ready.wait(lock, [&] { return produced > consumed || error || consumed == count; });
+    if (produced > consumed) return &slots[consumed % slots.size()];
+    if (error) std::rethrow_exception(error);
+    return nullptr;
+}
+
+void FramePrefetcher::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        consumed++;
+    }
+    slot_free.notify_one();
+}
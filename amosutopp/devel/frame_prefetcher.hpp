@@ -0,0 +1,46 @@
+#ifndef FRAME_PREFETCHER_HPP
+#define FRAME_PREFETCHER_HPP
+
+#include <chemfiles.hpp>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "trajectory_handler.hpp"
+
+// Reads frames begin, begin + stride, ... below end on a background thread
+// into a bounded ring, up to `depth` frames ahead of the consumer, so decoding overlaps the analysis.
+// The consumer takes one frame at a time with acquire() and hands its slot
+// back with release(). While the prefetcher is alive, only its thread may
+// touch the TrajectoryHandler.
+class FramePrefetcher {
+public:
+    FramePrefetcher(TrajectoryHandler& trajectory_handler, size_t begin, size_t end, size_t depth = 2,
+                    size_t stride = 1);
+    ~FramePrefetcher();
+
+    FramePrefetcher(const FramePrefetcher&) = delete;
+    FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+
+    // Next frame in order, nullptr once the range is exhausted. Blocks while
+    // the reader is behind, and rethrows any error raised while reading
+    const FrameBuffer* acquire();
+    void release();
+
+private:
+    void run();
+
+    TrajectoryHandler& trajectory_handler;
+    size_t begin, stride, count;
+    std::vector<FrameBuffer> slots;  // depth + 1: depth ahead plus the one in use, reused
+    size_t produced = 0, consumed = 0;   // frames written to / returned from the ring
+    bool stopping = false;
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable frame_ready, slot_free;
+    std::thread reader;
+};
+
+#endif // FRAME_PREFETCHER_HPP
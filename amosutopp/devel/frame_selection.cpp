@@ -0,0 +1,36 @@
+#include "frame_selection.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<size_t> FrameRange::frames(size_t n_frames) const {
+    if (stride == 0) throw std::runtime_error("FrameRange: stride must be at least 1");
+    std::vector<size_t> indices;
+    for (size_t i = begin; i < std::min(end, n_frames); i += stride) indices.push_back(i);
+    return indices;
+}
+
+std::vector<size_t> parse_atom_selection(const std::string& spec, size_t n_atoms) {
+    std::vector<size_t> atoms;
+    if (spec.empty() || spec == "all") return atoms;
+
+    std::stringstream items(spec);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        size_t dash = item.find('-');
+        size_t first, last;
+        try {
+            first = std::stoul(item.substr(0, dash));
+            last = dash == std::string::npos ? first : std::stoul(item.substr(dash + 1));
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("Atom selection: cannot parse '" + item + "'");
+        }
+        if (first > last || last >= n_atoms) {
+            throw std::runtime_error("Atom selection: '" + item + "' is outside 0-" + std::to_string(n_atoms - 1));
+        }
+        for (size_t a = first; a <= last; ++a) atoms.push_back(a);
+    }
+    std::sort(atoms.begin(), atoms.end());
+    atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+    return atoms;
+}
@@ -0,0 +1,23 @@
+#ifndef FRAME_SELECTION_HPP
+#define FRAME_SELECTION_HPP
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Frames begin, begin + stride, ... below end, clamped to the trajectory
+struct FrameRange {
+    size_t begin = 0;
+    size_t end = std::numeric_limits<size_t>::max();
+    size_t stride = 1;
+
+    std::vector<size_t> frames(size_t n_frames) const;
+};
+
+// Sorted, unique atom indices from "all" (empty result, meaning every atom)
+// or a comma-separated list of 0-based indices and inclusive ranges, e.g.
+// "0-99,250,300-310"; throws on indices >= n_atoms
+std::vector<size_t> parse_atom_selection(const std::string& spec, size_t n_atoms);
+
+#endif // FRAME_SELECTION_HPP
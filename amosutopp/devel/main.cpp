@@ -1,6 +1,7 @@
 #include <iostream>
 #include "mpi_handler.hpp"
 #include "trajectory_handler.hpp"
+#include "topology_broadcast.hpp"
 #include "analysis/perform_analysis.hpp"
 #include "analysis/rdf_analysis.hpp"
 #include "analysis/msd_analysis.hpp"
@@ -8,11 +9,13 @@
 
 int main(int argc, char** argv) {
     MPIHandler mpi_handler(argc, argv);
-    TrajectoryHandler trajectory_handler("static.dcd", "structure.data");
+    // Topology parsed on rank 0 only and shared through node memory
+    TrajectoryHandler trajectory_handler("static.dcd", broadcast_topology("structure.data"));
 
     // Check the command-line argument for the type of analysis
     if (argc < 2) {
-        std::cerr << "Please specify the type of analysis (rdf, msd, rmsd)" << std::endl;
+        std::cerr << "Please specify the type of analysis (rdf, msd, rmsd) [prefetch depth, default 2]"
+                  << " [--begin N] [--end N] [--stride N]" << std::endl;
         return 1;
     }
 
@@ -31,8 +34,24 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // Frames read ahead of the analysis (0 to read them in turn), and the
+    // frames to analyse
+    size_t prefetch_depth = 2;
+    FrameRange range;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "--begin" || arg == "--end" || arg == "--stride") && i + 1 < argc) {
+            size_t value = std::stoul(argv[++i]);
+            if (arg == "--begin") range.begin = value;
+            else if (arg == "--end") range.end = value;
+            else range.stride = value;
+        } else {
+            prefetch_depth = std::stoul(arg);
+        }
+    }
+
     // Perform the analysis
-    perform_analysis(analysis, trajectory_handler, mpi_handler);
+    perform_analysis(analysis, trajectory_handler, mpi_handler, prefetch_depth, range);
 
     delete analysis;  // Clean up the allocated analysis object
     return 0;
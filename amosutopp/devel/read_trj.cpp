@@ -1,27 +1,25 @@
 #include <iostream>
 #include <chemfiles.hpp>
+#include "trajectory_handler.hpp"
 
 int main() {
 
-        // Load the topology from structure.data
-        chemfiles::Trajectory topology_file("structure.data", 'r', "LAMMPS Data");
-        auto frame_topology = topology_file.read();  // Read the first frame to get the topology
+        // Open the static.dcd file (trajectory), with the topology from structure.data
+        TrajectoryHandler trajectory("static.dcd", "structure.data");
 
-        // Open the static.dcd file (trajectory)
-        chemfiles::Trajectory trajectory("static.dcd");
-
-        trajectory.set_topology("structure.data", "LAMMPS Data");
-
-        auto topology = trajectory.read().topology();
-        auto mass = topology[0].mass();
+        auto mass = trajectory.topology_arrays().masses()[0];
 
         // Get the total number of frames
-        size_t n_frames = trajectory.nsteps();
+        size_t n_frames = trajectory.get_n_frames();
+
+        // Storage reused for every frame
+        FrameBuffer buffer;
 
         for (size_t i = 0; i < n_frames; ++i) {
 
             // Read the i-th frame
-            auto frame = trajectory.read_step(i);
+            trajectory.read_into(i, buffer);
+            const auto& frame = buffer.frame;
 
             // Get the positions of all atoms
             auto positions = frame.positions();
@@ -30,7 +28,7 @@ int main() {
             auto first_position = positions[0];
 
             // Get the first atom's name from the topology
-            // auto topol = frame_topology.topology();  // Using topology to get the name
+            // auto topol = *buffer.topology;  // Using topology to get the name
             // auto atom_type = topol[0].type();
             // auto atom_mass = topol[0].mass();
 
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <chemfiles.hpp>
+#include "topology_broadcast.hpp"
+#include "trajectory_handler.hpp"
 #include </opt/homebrew/Cellar/open-mpi/5.0.3_1/include/mpi.h>
 
 int main(int argc, char** argv) {
@@ -15,21 +17,21 @@ int main(int argc, char** argv) {
     int world_rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
 
-    // Load the topology from structure.data (only by the master process)
-    chemfiles::Trajectory topology_file("structure.data", 'r', "LAMMPS Data");
-    auto frame_topology = topology_file.read();  // Read the first frame to get the topology
+    // Load the topology from structure.data (only by the master process,
+    // shared with the other ranks through node memory)
+    TopologyCache topology = broadcast_topology("structure.data", MPI_COMM_WORLD);
 
-    // Open the static.dcd file (trajectory)
-    chemfiles::Trajectory trajectory("static.dcd");
+    auto atom_mass = topology.masses()[0];
 
-    trajectory.set_topology("structure.data", "LAMMPS Data");
+    // Open the static.dcd file (trajectory). Every process opens it: the
+    // native DCD reader maps the file and takes the number of frames from its
+    // header, without chemfiles (analysis_mpi reads the header on the master
+    // process only, with CollectiveDCDReader)
+    TrajectoryHandler trajectory("static.dcd", topology);
+    size_t n_frames = trajectory.get_n_frames();
 
-    auto topology = trajectory.read().topology();
-    auto atom_mass = topology[0].mass();
-
-    // Get the total number of frames (do it only on one process and broadcast it)
-    size_t n_frames = trajectory.nsteps();
-    MPI_Bcast(&n_frames, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    // Storage reused for every frame
+    FrameBuffer buffer;
 
     // Calculate the frames each process should handle
     size_t frames_per_process = n_frames / world_size;
@@ -40,7 +42,8 @@ int main(int argc, char** argv) {
     for (size_t i = start_frame; i < end_frame; ++i) {
 
         // Read the i-th frame
-        auto frame = trajectory.read_step(i);
+        trajectory.read_into(i, buffer);
+        const auto& frame = buffer.frame;
 
         // Get the positions of all atoms
         auto positions = frame.positions();
@@ -23,10 +23,8 @@ int main() {
     // Preallocate a 1D vector for positions (flattened 3D array: n_frames * n_particles * 3)
     std::vector<float> positions_flattened(n_frames * n_particles * 3, 0.0f);
 
-    // Loop over all frames to accumulate positions
+    // Loop over all frames to copy the positions
     for (size_t i = 0; i < n_frames; ++i) {
-        std::cout << "Processing frame " << i << " (Flattened std::vector)" << std::endl;
-
         // Read the i-th frame
         frame = trajectory.read_step(i);
 
@@ -36,12 +34,12 @@ int main() {
         // Precompute the base index for the current frame
         size_t base_index = i * n_particles * 3;
 
-        // Add the current positions to the preallocated positions array
+        // Copy the current positions into the preallocated positions array
         for (size_t j = 0; j < n_particles; ++j) {
             size_t particle_base_index = base_index + j * 3;
-            positions_flattened[particle_base_index + 0] += current_positions[j][0]; // x-coordinate
-            positions_flattened[particle_base_index + 1] += current_positions[j][1]; // y-coordinate
-            positions_flattened[particle_base_index + 2] += current_positions[j][2]; // z-coordinate
+            positions_flattened[particle_base_index + 0] = current_positions[j][0]; // x-coordinate
+            positions_flattened[particle_base_index + 1] = current_positions[j][1]; // y-coordinate
+            positions_flattened[particle_base_index + 2] = current_positions[j][2]; // z-coordinate
         }
     }
 
@@ -57,21 +55,19 @@ int main() {
     // Preallocate a 3D boost::multi_array for positions (n_frames x n_particles x 3)
     boost::multi_array<float, 3> positions_multi(boost::extents[n_frames][n_particles][3]);
 
-    // Loop over all frames to accumulate positions
+    // Loop over all frames to copy the positions
     for (size_t i = 0; i < n_frames; ++i) {
-        std::cout << "Processing frame " << i << " (boost::multi_array)" << std::endl;
-
         // Read the i-th frame
         frame = trajectory.read_step(i);
 
         // Get the positions of all atoms as a span (view)
         auto current_positions = frame.positions();
 
-        // Add the current positions to the preallocated boost::multi_array
+        // Copy the current positions into the preallocated boost::multi_array
         for (size_t j = 0; j < n_particles; ++j) {
-            positions_multi[i][j][0] += current_positions[j][0]; // x-coordinate
-            positions_multi[i][j][1] += current_positions[j][1]; // y-coordinate
-            positions_multi[i][j][2] += current_positions[j][2]; // z-coordinate
+            positions_multi[i][j][0] = current_positions[j][0]; // x-coordinate
+            positions_multi[i][j][1] = current_positions[j][1]; // y-coordinate
+            positions_multi[i][j][2] = current_positions[j][2]; // z-coordinate
         }
     }
 
@@ -104,28 +100,28 @@ int main() {
     // Preallocate a 1D vector for positions (flattened 3D array: n_frames * n_particles * 3)
     std::vector<float> positions_flattened(n_frames * n_particles * 3, 0.0f);
 
-    // Loop over all frames to accumulate positions
+    // Loop over all frames to copy the positions
     for (size_t i = 0; i < n_frames; ++i) {
         frame = trajectory.read_step(i);
         auto current_positions = frame.positions();
         size_t base_index = i * n_particles * 3;
         for (size_t j = 0; j < n_particles; ++j) {
             size_t particle_base_index = base_index + j * 3;
-            positions_flattened[particle_base_index + 0] += current_positions[j][0];
-            positions_flattened[particle_base_index + 1] += current_positions[j][1];
-            positions_flattened[particle_base_index + 2] += current_positions[j][2];
+            positions_flattened[particle_base_index + 0] = current_positions[j][0];
+            positions_flattened[particle_base_index + 1] = current_positions[j][1];
+            positions_flattened[particle_base_index + 2] = current_positions[j][2];
         }
     }
 
     // Create a 3D mdspan view over the flattened positions array
     mdspan_3d positions_view(positions_flattened.data(), n_frames, n_particles, 3);
 
-    // Example of accessing the accumulated positions using mdspan (print the first frame)
+    // Example of accessing the positions using mdspan (print the first frame)
     for (size_t j = 0; j < n_particles; ++j) {
         std::cout << "Particle " << j << ": x = " 
                   << positions_view(0, j, 0) << ", y = "
                   << positions_view(0, j, 1) << ", z = "
-                  << positions_view(0, j, 2) << std::endl;
+                  << positions_view(0, j, 2) << '\n';
     }
 
     return 0;
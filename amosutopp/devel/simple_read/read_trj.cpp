@@ -1,48 +1,33 @@
 #include <iostream>
-#include <chemfiles.hpp>
 #include <vector>
+#include "../trajectory_handler.hpp"
+#include "../trajectory_tensor.hpp"
 
 int main() {
-    // Open the static.dcd file (trajectory)
-    chemfiles::Trajectory trajectory("/Users/thibaut/opt/dev/codealchemy/amosutopp/devel/cfiles/static.dcd");
-    
-    // Get the total number of frames and the number of particles
-    size_t n_frames = trajectory.nsteps();
-    auto frame = trajectory.read_step(0);
-    size_t n_particles = frame.size(); // Number of particles in a frame
+    const std::string directory = "/Users/thibaut/opt/dev/codealchemy/amosutopp/devel/cfiles/";
 
-    // Preallocate a 1D vector for positions (flattened 3D array: n_frames * n_particles * 3)
-    std::vector<float> positions(n_frames * n_particles * 3, 0.0f);
+    // Topology of the static.dcd file (trajectory), for the number of particles
+    TopologyCache topology = TopologyCache::open(directory + "structure.data");
+    size_t n_particles = topology.n_atoms();  // Number of particles in a frame
 
-    // Loop over all frames to accumulate positions
-    for (size_t i = 0; i < n_frames; ++i) {
-        std::cout << "Processing frame " << i << std::endl;
+    // Every frame
+    size_t n_frames = TrajectoryHandler(directory + "static.dcd", topology).get_n_frames();
+    std::vector<size_t> frames(n_frames);
+    for (size_t i = 0; i < n_frames; ++i) frames[i] = i;
 
-        // Read the i-th frame
-        frame = trajectory.read_step(i);
+    // Decode all frames in parallel, one reader per thread, straight into a
+    // single preallocated (n_frames x n_particles x 3) tensor
+    TrajectoryTensor tensor = load_trajectory(directory + "static.dcd", topology, frames, {});
+    auto positions = tensor.view<float>();
+    std::cout << "Loaded " << n_frames << " frames of " << n_particles << " particles\n";
 
-        // Get the positions of all atoms as a span (view)
-        auto current_positions = frame.positions();
-
-        // Precompute the base index for the current frame
-        size_t base_index = i * n_particles * 3;
-
-        // Add the current positions to the preallocated positions array
-        for (size_t j = 0; j < n_particles; ++j) {
-            size_t particle_base_index = base_index + j * 3;
-            positions[particle_base_index + 0] += current_positions[j][0]; // x-coordinate
-            positions[particle_base_index + 1] += current_positions[j][1]; // y-coordinate
-            positions[particle_base_index + 2] += current_positions[j][2]; // z-coordinate
-        }
-    }
-
-    // Example of accessing the accumulated positions (print the first frame)
+    // Example of accessing the positions (print the first frame)
     for (size_t j = 0; j < n_particles; ++j) {
-        std::cout << "Particle " << j << ": x = " 
-                  << positions[j * 3 + 0] << ", y = "
-                  << positions[j * 3 + 1] << ", z = "
-                  << positions[j * 3 + 2] << std::endl;
+        std::cout << "Particle " << j << ": x = "
+                  << positions(0, j, 0) << ", y = "
+                  << positions(0, j, 1) << ", z = "
+                  << positions(0, j, 2) << '\n';
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,204 @@
+#include "text_frame_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t npos = static_cast<size_t>(-1);
+
+struct Cursor {
+    const char* p;
+    const char* end;
+
+    bool done() const { return p >= end; }
+
+    void skip_line() {
+        const void* newline = std::memchr(p, '\n', end - p);
+        p = newline ? static_cast<const char*>(newline) + 1 : end;
+    }
+
+    std::string_view line() {
+        const char* begin = p;
+        skip_line();
+        const char* last = p;
+        while (last > begin && (last[-1] == '\n' || last[-1] == '\r')) --last;
+        return {begin, static_cast<size_t>(last - begin)};
+    }
+
+    void skip_blanks() {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    }
+
+    void skip_token() {
+        skip_blanks();
+        while (p < end && !std::isspace(static_cast<unsigned char>(*p))) ++p;
+    }
+
+    template <class T>
+    T number() {
+        skip_blanks();
+        T value{};
+        auto [ptr, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc()) throw std::runtime_error("parse_positions: expected a number");
+        p = ptr;
+        return value;
+    }
+};
+
+template <class T>
+void parse_xyz(Cursor c, std::span<const size_t> atoms, std::vector<T>& xyz) {
+    size_t n = c.number<size_t>();
+    c.skip_line();
+    c.skip_line();  // comment
+    if (!atoms.empty() && atoms.back() >= n) throw std::runtime_error("parse_positions: selected atom beyond the frame");
+
+    size_t n_out = atoms.empty() ? n : atoms.size();
+    xyz.resize(3 * n_out);
+    size_t next = 0;
+    for (size_t a = 0; a < n && next < n_out; ++a) {  // stops after the last selected atom
+        if (c.done()) break;
+        if (!atoms.empty() && atoms[next] != a) {
+            c.skip_line();
+            continue;
+        }
+        c.skip_token();  // element
+        for (int d = 0; d < 3; ++d) xyz[3 * next + d] = c.number<T>();
+        c.skip_line();
+        next++;
+    }
+    if (next != n_out) throw std::runtime_error("parse_positions: truncated XYZ frame");
+}
+
+template <class T>
+void parse_lammps(Cursor c, std::span<const size_t> atoms, std::vector<T>& xyz, std::array<double, 6>* cell) {
+    size_t n = 0;
+    double lo[3] = {0.0, 0.0, 0.0}, length[3] = {1.0, 1.0, 1.0}, tilt[3] = {0.0, 0.0, 0.0};  // tilt: xy, xz, yz
+    bool triclinic = false;
+    std::string_view header;
+    while (!c.done()) {
+        std::string_view line = c.line();
+        if (line.starts_with("ITEM: NUMBER OF ATOMS")) {
+            n = c.number<size_t>();
+            c.skip_line();
+        } else if (line.starts_with("ITEM: BOX BOUNDS")) {
+            triclinic = line.find("xy") != std::string_view::npos;
+            for (int d = 0; d < 3; ++d) {
+                lo[d] = c.number<double>();
+                length[d] = c.number<double>() - lo[d];
+                if (triclinic) tilt[d] = c.number<double>();
+                c.skip_line();
+            }
+            if (triclinic) {
+                // Bounds of a triclinic box enclose the tilted cell
+                length[0] -= std::max({0.0, tilt[0], tilt[1], tilt[0] + tilt[1]}) -
+                             std::min({0.0, tilt[0], tilt[1], tilt[0] + tilt[1]});
+                length[1] -= std::max(0.0, tilt[2]) - std::min(0.0, tilt[2]);
+            }
+        } else if (line.starts_with("ITEM: ATOMS")) {
+            header = line.substr(11);
+            break;
+        }
+    }
+
+    // Columns of the id and of the coordinates, unscaled preferred
+    std::vector<std::string_view> columns;
+    for (size_t p = 0; p < header.size();) {
+        size_t q = header.find_first_not_of(' ', p);
+        if (q == std::string_view::npos) break;
+        p = std::min(header.find(' ', q), header.size());
+        columns.push_back(header.substr(q, p - q));
+    }
+    auto column = [&](std::string_view name) {
+        auto it = std::find(columns.begin(), columns.end(), name);
+        return it == columns.end() ? -1 : static_cast<int>(it - columns.begin());
+    };
+    const char* names[3][4] = {{"x", "xu", "xs", "xsu"}, {"y", "yu", "ys", "ysu"}, {"z", "zu", "zs", "zsu"}};
+    int id_column = column("id"), coordinate[3];
+    bool scaled = false;
+    for (int d = 0; d < 3; ++d) {
+        coordinate[d] = -1;
+        for (int k = 0; k < 4 && coordinate[d] < 0; ++k) {
+            coordinate[d] = column(names[d][k]);
+            if (coordinate[d] >= 0) scaled = k >= 2;
+        }
+        if (coordinate[d] < 0) throw std::runtime_error("parse_positions: no coordinate columns in the LAMMPS dump");
+    }
+    if (scaled && triclinic) throw std::runtime_error("parse_positions: scaled coordinates in a triclinic box");
+
+    if (cell) {
+        constexpr double degrees = 180.0 / 3.14159265358979323846;
+        double length_a = length[0];
+        double length_b = std::sqrt(length[1] * length[1] + tilt[0] * tilt[0]);
+        double length_c = std::sqrt(length[2] * length[2] + tilt[1] * tilt[1] + tilt[2] * tilt[2]);
+        double alpha = std::acos((tilt[0] * tilt[1] + length[1] * tilt[2]) / (length_b * length_c));
+        *cell = {length_a, length_b, length_c, alpha * degrees, std::acos(tilt[1] / length_c) * degrees,
+                 std::acos(tilt[0] / length_b) * degrees};
+    }
+
+    int last_column = std::max({id_column, coordinate[0], coordinate[1], coordinate[2]});
+
+    // Output slot of an atom index, npos when it is not selected
+    auto slot = [&](size_t index) {
+        if (atoms.empty()) return index < n ? index : npos;
+        auto it = std::lower_bound(atoms.begin(), atoms.end(), index);
+        return it != atoms.end() && *it == index ? static_cast<size_t>(it - atoms.begin()) : npos;
+    };
+
+    size_t n_out = atoms.empty() ? n : atoms.size();
+    xyz.resize(3 * n_out);
+    size_t found = 0;
+    for (size_t row = 0; row < n && !c.done(); ++row) {
+        size_t s = id_column < 0 ? slot(row) : npos;
+        double value[3] = {0.0, 0.0, 0.0};
+        bool wanted = id_column >= 0 || s != npos;
+        for (int col = 0; col <= last_column && wanted; ++col) {
+            if (col == id_column) {
+                s = slot(c.number<size_t>() - 1);
+                wanted = s != npos;
+            } else if (col == coordinate[0] || col == coordinate[1] || col == coordinate[2]) {
+                int d = col == coordinate[0] ? 0 : col == coordinate[1] ? 1 : 2;
+                value[d] = c.number<double>();
+            } else {
+                c.skip_token();
+            }
+        }
+        if (wanted) {
+            for (int d = 0; d < 3; ++d) {
+                xyz[3 * s + d] = static_cast<T>(scaled ? lo[d] + value[d] * length[d] : value[d]);
+            }
+            found++;
+        }
+        c.skip_line();
+    }
+    if (found != n_out) throw std::runtime_error("parse_positions: selected atoms missing from the LAMMPS frame");
+}
+
+template <class T>
+void parse(std::string_view text, const std::string& format, std::span<const size_t> atoms, std::vector<T>& xyz,
+           std::array<double, 6>* cell) {
+    Cursor c{text.data(), text.data() + text.size()};
+    if (format == "XYZ") {
+        if (cell) *cell = {};
+        parse_xyz(c, atoms, xyz);
+    } else if (format == "LAMMPS") {
+        parse_lammps(c, atoms, xyz, cell);
+    } else {
+        throw std::runtime_error("parse_positions: no native parser for format '" + format + "'");
+    }
+}
+
+}
+
+void parse_positions(std::string_view text, const std::string& format, std::span<const size_t> atoms,
+                     std::vector<float>& xyz, std::array<double, 6>* cell) {
+    parse(text, format, atoms, xyz, cell);
+}
+
+void parse_positions(std::string_view text, const std::string& format, std::span<const size_t> atoms,
+                     std::vector<double>& xyz, std::array<double, 6>* cell) {
+    parse(text, format, atoms, xyz, cell);
+}
@@ -0,0 +1,26 @@
+#ifndef TEXT_FRAME_PARSER_HPP
+#define TEXT_FRAME_PARSER_HPP
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Positions of the selected `atoms` (sorted indices, empty for every atom)
+// from the text of one XYZ or LAMMPS dump frame, as x, y, z per atom in
+// selection order. Only the fields that are needed are converted: lines of
+// unselected atoms are skipped, and so are the columns other than the id and
+// the coordinates. LAMMPS dumps may be unsorted; atoms are matched by id
+// (id - 1 is the index), and scaled coordinates are unscaled in
+// orthorhombic boxes. If `cell` is given it receives the box of LAMMPS
+// frames as lengths and angles in degrees (a, b, c, alpha, beta, gamma), and
+// zeros for XYZ frames. Into doubles, the numbers keep the precision of the
+// text; into floats, they are rounded to single precision.
+void parse_positions(std::string_view text, const std::string& format, std::span<const size_t> atoms,
+                     std::vector<float>& xyz, std::array<double, 6>* cell = nullptr);
+void parse_positions(std::string_view text, const std::string& format, std::span<const size_t> atoms,
+                     std::vector<double>& xyz, std::array<double, 6>* cell = nullptr);
+
+#endif // TEXT_FRAME_PARSER_HPP
@@ -0,0 +1,71 @@
+#include "topology_broadcast.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+
+TopologyCache broadcast_topology(const std::string& data_file, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Ranks sharing memory, and one leader (local rank 0) per node; with the
+    // rank as key, rank 0 leads its node and is rank 0 among the leaders
+    MPI_Comm node, leaders;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    int node_rank;
+    MPI_Comm_rank(node, &node_rank);
+    MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leaders);
+
+    // A failure on rank 0 is broadcast as UINT64_MAX, so that every rank
+    // throws instead of waiting for an image that never comes
+    TopologyCache root_cache;
+    uint64_t bytes = 0;
+    std::string error;
+    if (rank == 0) {
+        try {
+            root_cache = TopologyCache::open(data_file);
+            bytes = root_cache.image_bytes();
+        } catch (const std::exception& e) {
+            error = e.what();
+            bytes = UINT64_MAX;
+        }
+    }
+    MPI_Bcast(&bytes, 1, MPI_UINT64_T, 0, comm);
+    if (bytes == UINT64_MAX) {
+        MPI_Comm_free(&node);
+        if (leaders != MPI_COMM_NULL) MPI_Comm_free(&leaders);
+        throw std::runtime_error("broadcast_topology: rank 0 cannot open " + data_file +
+                                 (error.empty() ? std::string() : ": " + error));
+    }
+
+    char* base = nullptr;
+    MPI_Win window;
+    MPI_Win_allocate_shared(node_rank == 0 ? static_cast<MPI_Aint>(bytes) : 0, 1, MPI_INFO_NULL, node, &base, &window);
+    if (node_rank != 0) {
+        MPI_Aint size;
+        int displacement;
+        MPI_Win_shared_query(window, 0, &size, &displacement, &base);
+    }
+
+    MPI_Win_fence(0, window);
+    if (leaders != MPI_COMM_NULL) {
+        if (rank == 0) std::memcpy(base, root_cache.image_data(), bytes);
+        for (uint64_t offset = 0; offset < bytes; offset += INT_MAX) {
+            int count = static_cast<int>(std::min<uint64_t>(bytes - offset, INT_MAX));
+            MPI_Bcast(base + offset, count, MPI_BYTE, 0, leaders);
+        }
+        MPI_Comm_free(&leaders);
+    }
+    MPI_Win_fence(0, window);  // the node's copy is visible to all its ranks
+    MPI_Comm_free(&node);
+
+    std::shared_ptr<const void> image(base, [window](const void*) mutable {
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized) MPI_Win_free(&window);
+    });
+    return TopologyCache::from_image(std::move(image), bytes);
+}
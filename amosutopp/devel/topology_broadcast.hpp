@@ -0,0 +1,17 @@
+#ifndef TOPOLOGY_BROADCAST_HPP
+#define TOPOLOGY_BROADCAST_HPP
+
+#include <mpi.h>
+#include <string>
+#include "topology_cache.hpp"
+
+// Topology of `data_file` on every rank of `comm` with a single parse: rank 0
+// opens the cache (parsing the data file if needed) and broadcasts its flat
+// image to one rank per node, which writes it into an MPI shared-memory
+// window that every rank of the node maps. Collective over `comm`; the window
+// is freed when the last copy of the returned cache goes, which must happen
+// on all ranks of a node (or after MPI_Finalize, when it is left to MPI).
+// If rank 0 cannot open the data file, every rank throws.
+TopologyCache broadcast_topology(const std::string& data_file, MPI_Comm comm = MPI_COMM_WORLD);
+
+#endif // TOPOLOGY_BROADCAST_HPP
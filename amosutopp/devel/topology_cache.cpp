@@ -0,0 +1,230 @@
+#include "topology_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char magic[8] = {'T', 'O', 'P', 'O', 'C', 'A', 'C', 'H'};
+constexpr uint64_t version = 1;
+
+// Every section starts on an 8-byte boundary
+struct Header {
+    char magic[8];
+    uint64_t version;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t atoms;
+    uint64_t bonds;
+    uint64_t strings;
+    uint64_t string_bytes;
+};
+
+size_t padded(size_t bytes) { return (bytes + 7) & ~size_t(7); }
+
+size_t image_size(const Header& h) {
+    return sizeof(Header) + 3 * 8 * h.atoms + 2 * padded(4 * h.atoms) + 16 * h.bonds + 8 * (h.strings + 1) +
+           padded(h.string_bytes);
+}
+
+int64_t modification_time(const std::string& path) {
+    return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
+
+// Parses the data file with chemfiles and lays out the cache image in memory
+std::shared_ptr<std::vector<uint64_t>> build_image(const std::string& data_file, uint64_t size, int64_t mtime) {
+    auto topology = chemfiles::Trajectory(data_file, 'r', "LAMMPS Data").read().topology();
+    size_t n = topology.size();
+
+    std::vector<uint32_t> type(n), name(n);
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> string_ids;
+    auto intern = [&](const std::string& s) {
+        auto [it, inserted] = string_ids.emplace(s, static_cast<uint32_t>(strings.size()));
+        if (inserted) strings.push_back(s);
+        return it->second;
+    };
+
+    Header h{};
+    std::memcpy(h.magic, magic, sizeof(magic));
+    h.version = version;
+    h.source_size = size;
+    h.source_mtime = mtime;
+    h.atoms = n;
+    h.bonds = topology.bonds().size();
+    for (size_t i = 0; i < n; ++i) {
+        type[i] = intern(topology[i].type());
+        name[i] = intern(topology[i].name());
+    }
+    h.strings = strings.size();
+    for (const auto& s : strings) h.string_bytes += s.size();
+
+    auto image = std::make_shared<std::vector<uint64_t>>(image_size(h) / 8, 0);
+    char* p = reinterpret_cast<char*>(image->data());
+    auto put = [&](const void* data, size_t bytes) {
+        if (bytes > 0) std::memcpy(p, data, bytes);
+        p += padded(bytes);
+    };
+    put(&h, sizeof(h));
+
+    std::vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) values[i] = topology[i].mass();
+    put(values.data(), 8 * n);
+    for (size_t i = 0; i < n; ++i) values[i] = topology[i].charge();
+    put(values.data(), 8 * n);
+
+    std::vector<int64_t> molecule(n, -1);
+    for (size_t i = 0; i < n; ++i) {
+        auto residue = topology.residue_for_atom(i);
+        if (residue && residue->id()) molecule[i] = *residue->id();
+    }
+    put(molecule.data(), 8 * n);
+    put(type.data(), 4 * n);
+    put(name.data(), 4 * n);
+
+    std::vector<uint64_t> bonds;
+    bonds.reserve(2 * h.bonds);
+    for (const auto& bond : topology.bonds()) {
+        bonds.push_back(bond[0]);
+        bonds.push_back(bond[1]);
+    }
+    put(bonds.data(), 8 * bonds.size());
+
+    std::vector<uint64_t> offsets(1, 0);
+    std::string chars;
+    for (const auto& s : strings) {
+        chars += s;
+        offsets.push_back(chars.size());
+    }
+    put(offsets.data(), 8 * offsets.size());
+    put(chars.data(), chars.size());
+    return image;
+}
+
+// Written aside and renamed, so concurrent runs (or threads) never map half a cache
+void save(const std::string& path, const std::vector<uint64_t>& image) {
+    std::string tmp = path + ".tmp." + std::to_string(getpid()) + "." +
+                      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(8 * image.size()));
+        if (!out) {
+            out.close();
+            std::remove(tmp.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) std::remove(tmp.c_str());
+}
+
+// Read-only mapping of `path`, null if it cannot be mapped
+std::shared_ptr<const void> map_file(const std::string& path, size_t& size) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        return nullptr;
+    }
+    size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return nullptr;
+    return std::shared_ptr<const void>(map, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+}
+
+}
+
+TopologyCache TopologyCache::open(const std::string& data_file) {
+    std::string path = data_file + ".topo";
+    uint64_t size = std::filesystem::file_size(data_file);
+    int64_t mtime = modification_time(data_file);
+
+    TopologyCache cache;
+    size_t mapped_size = 0;
+    if (auto mapped = map_file(path, mapped_size)) {
+        const Header* h = static_cast<const Header*>(mapped.get());
+        if (h->source_size == size && h->source_mtime == mtime && cache.attach(mapped, mapped_size)) {
+            return cache;
+        }
+    }
+
+    // First run (or a stale cache): parse, save, and use the image in memory
+    auto image = build_image(data_file, size, mtime);
+    save(path, *image);
+    if (!cache.attach(std::shared_ptr<const void>(image, image->data()), 8 * image->size())) {
+        throw std::runtime_error("TopologyCache: inconsistent cache image for " + data_file);
+    }
+    return cache;
+}
+
+TopologyCache TopologyCache::from_image(std::shared_ptr<const void> data, size_t size) {
+    TopologyCache cache;
+    if (size < sizeof(Header) || !cache.attach(std::move(data), size)) {
+        throw std::runtime_error("TopologyCache: not a topology cache image");
+    }
+    return cache;
+}
+
+bool TopologyCache::attach(std::shared_ptr<const void> data, size_t size) {
+    const Header* h = static_cast<const Header*>(data.get());
+    if (std::memcmp(h->magic, magic, sizeof(magic)) != 0 || h->version != version || image_size(*h) != size) {
+        return false;
+    }
+
+    const char* p = static_cast<const char*>(data.get()) + sizeof(Header);
+    auto take = [&](size_t section_bytes) {
+        const char* section = p;
+        p += padded(section_bytes);
+        return section;
+    };
+    atoms = h->atoms;
+    bond_count = h->bonds;
+    n_strings = h->strings;
+    mass = reinterpret_cast<const double*>(take(8 * atoms));
+    charge = reinterpret_cast<const double*>(take(8 * atoms));
+    molecule = reinterpret_cast<const int64_t*>(take(8 * atoms));
+    type_index = reinterpret_cast<const uint32_t*>(take(4 * atoms));
+    name_index = reinterpret_cast<const uint32_t*>(take(4 * atoms));
+    bond = reinterpret_cast<const uint64_t*>(take(16 * bond_count));
+    string_offset = reinterpret_cast<const uint64_t*>(take(8 * (n_strings + 1)));
+    strings = take(h->string_bytes);
+    image = std::move(data);
+    bytes = size;
+    return true;
+}
+
+std::string TopologyCache::lookup(uint32_t id) const {
+    return std::string(strings + string_offset[id], string_offset[id + 1] - string_offset[id]);
+}
+
+chemfiles::Topology TopologyCache::to_topology() const {
+    chemfiles::Topology topology;
+    for (size_t i = 0; i < atoms; ++i) {
+        chemfiles::Atom atom(name(i), type(i));
+        atom.set_mass(mass[i]);
+        atom.set_charge(charge[i]);
+        topology.add_atom(std::move(atom));
+    }
+    for (size_t b = 0; b < bond_count; ++b) topology.add_bond(bond[2 * b], bond[2 * b + 1]);
+
+    // One residue per molecule id, as the LAMMPS data reader creates them
+    std::map<int64_t, chemfiles::Residue> residues;
+    for (size_t i = 0; i < atoms; ++i) {
+        if (molecule[i] < 0) continue;
+        auto it = residues.try_emplace(molecule[i], chemfiles::Residue("", molecule[i])).first;
+        it->second.add_atom(i);
+    }
+    for (auto& [id, residue] : residues) topology.add_residue(std::move(residue));
+    return topology;
+}
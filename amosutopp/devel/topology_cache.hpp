@@ -0,0 +1,59 @@
+#ifndef TOPOLOGY_CACHE_HPP
+#define TOPOLOGY_CACHE_HPP
+
+#include <chemfiles.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+// Binary cache of a LAMMPS data topology in `<data file>.topo`: per-atom
+// arrays (types, names, masses, charges, molecule ids) and the bond list,
+// written the first time the data file is parsed and memory-mapped on later
+// runs. The cache is trusted only while the data file's size and
+// modification time match the ones it records.
+class TopologyCache {
+public:
+    static TopologyCache open(const std::string& data_file);
+
+    // Cache over an image someone else holds (e.g. an MPI shared window);
+    // `image` owns it and releases it with the last copy
+    static TopologyCache from_image(std::shared_ptr<const void> image, size_t bytes);
+
+    // The flat image itself, for shipping it to other processes
+    const void* image_data() const { return image.get(); }
+    size_t image_bytes() const { return bytes; }
+
+    size_t n_atoms() const { return atoms; }
+    size_t n_bonds() const { return bond_count; }
+
+    std::span<const double> masses() const { return {mass, atoms}; }
+    std::span<const double> charges() const { return {charge, atoms}; }
+    std::span<const int64_t> molecule_ids() const { return {molecule, atoms}; }  // -1 without a molecule
+    std::span<const uint32_t> type_ids() const { return {type_index, atoms}; }         // index into the string table
+    std::span<const uint64_t> bonds() const { return {bond, 2 * bond_count}; }  // i0, j0, i1, j1, ...
+
+    std::string type(size_t atom) const { return lookup(type_index[atom]); }
+    std::string name(size_t atom) const { return lookup(name_index[atom]); }
+
+    // chemfiles topology rebuilt from the arrays, for frames and trajectories
+    chemfiles::Topology to_topology() const;
+
+private:
+    bool attach(std::shared_ptr<const void> image, size_t image_size);
+    std::string lookup(uint32_t id) const;
+
+    std::shared_ptr<const void> image;  // the mapping (or the in-memory image), released with the last copy
+    size_t bytes = 0;
+    size_t atoms = 0, bond_count = 0, n_strings = 0;
+    const double* mass = nullptr;
+    const double* charge = nullptr;
+    const int64_t* molecule = nullptr;
+    const uint32_t* type_index = nullptr;
+    const uint32_t* name_index = nullptr;
+    const uint64_t* bond = nullptr;
+    const uint64_t* string_offset = nullptr;  // n_strings + 1 into `strings`
+    const char* strings = nullptr;
+};
+
+#endif // TOPOLOGY_CACHE_HPP
@@ -1,15 +1,164 @@
 #include "trajectory_handler.hpp"
+#include "text_frame_parser.hpp"
+#include <stdexcept>
+#include <utility>
 
 TrajectoryHandler::TrajectoryHandler(const std::string& trajectory_file, const std::string& topology_file)
-    : trajectory(trajectory_file) {
-    trajectory.set_topology(topology_file, "LAMMPS Data");
-    n_frames = trajectory.nsteps();
+    : TrajectoryHandler(trajectory_file, TopologyCache::open(topology_file)) {}
+
+TrajectoryHandler::TrajectoryHandler(const std::string& trajectory_file, TopologyCache topology_cache)
+    : topology_cache(std::move(topology_cache)), topology(std::make_shared<const chemfiles::Topology>(this->topology_cache.to_topology())) {
+    open(trajectory_file);
+}
+
+TrajectoryHandler TrajectoryHandler::positions_only(const std::string& trajectory_file,
+                                                    std::shared_ptr<const FrameIndex> index) {
+    TrajectoryHandler handler;
+    handler.with_topology = false;
+    handler.index = std::move(index);
+    handler.open(trajectory_file);
+    return handler;
+}
+
+void TrajectoryHandler::open(const std::string& trajectory_file) {
+    path = trajectory_file;
+    if (DCDReader::can_read(trajectory_file)) {
+        try {
+            dcd = std::make_unique<DCDReader>(trajectory_file);
+        } catch (const std::runtime_error&) {
+            dcd.reset();  // chemfiles still reads it
+        }
+    }
+
+    format = FrameIndex::format_of(trajectory_file);
+    if (!format.empty()) {
+        if (!index) index = std::make_shared<const FrameIndex>(FrameIndex::open(trajectory_file, format));
+        text.open(trajectory_file, std::ios::binary);
+        n_frames = index->n_frames();
+    } else if (dcd) {
+        n_frames = dcd->n_frames();  // chemfiles is only opened if read_frame needs it
+    } else {
+        n_frames = chemfiles_trajectory().nsteps();
+    }
+}
+
+chemfiles::Trajectory& TrajectoryHandler::chemfiles_trajectory() {
+    if (!trajectory) {
+        trajectory = std::make_unique<chemfiles::Trajectory>(path);
+        if (with_topology) trajectory->set_topology(*topology);
+    }
+    return *trajectory;
 }
 
 size_t TrajectoryHandler::get_n_frames() const {
     return n_frames;
 }
 
+std::string_view TrajectoryHandler::read_text(size_t i) {
+    if (i >= n_frames) throw std::runtime_error("TrajectoryHandler: frame index out of range");
+    frame_text.resize(index->size(i));
+    text.seekg(static_cast<std::streamoff>(index->offset(i)));
+    text.read(frame_text.data(), static_cast<std::streamsize>(frame_text.size()));
+    if (!text) throw std::runtime_error("TrajectoryHandler: cannot read frame " + std::to_string(i));
+    return frame_text;
+}
+
 chemfiles::Frame TrajectoryHandler::read_frame(size_t i) {
-    return trajectory.read_step(i);
+    if (!with_topology) throw std::runtime_error("TrajectoryHandler: handle opened for positions only");
+    if (!index) return chemfiles_trajectory().read_step(i);
+
+    std::string_view slice = read_text(i);
+    auto frame = chemfiles::Trajectory::memory_reader(slice.data(), slice.size(), format).read();
+    frame.set_topology(*topology);
+    return frame;
+}
+
+void FrameBuffer::attach(const std::shared_ptr<const chemfiles::Topology>& topology, size_t n_atoms) {
+    if (this->topology != topology || frame.size() != n_atoms) {
+        frame.resize(n_atoms);
+        frame.set_topology(*topology);
+        this->topology = topology;
+    }
+}
+
+void TrajectoryHandler::read_into(size_t i, FrameBuffer& buffer) {
+    if (!with_topology) throw std::runtime_error("TrajectoryHandler: handle opened for positions only");
+    std::array<double, 6> cell{};
+    if (dcd) {
+        if (i >= n_frames) throw std::runtime_error("TrajectoryHandler: frame index out of range");
+        buffer.attach(topology, dcd->n_atoms());
+        auto positions = buffer.frame.positions();
+        auto x = dcd->x(i), y = dcd->y(i), z = dcd->z(i);
+        for (size_t a = 0; a < positions.size(); ++a) positions[a] = chemfiles::Vector3D(x[a], y[a], z[a]);
+        cell = dcd->cell(i);
+    } else if (index) {
+        parse_positions(read_text(i), format, {}, scratch, &cell);
+        buffer.attach(topology, scratch.size() / 3);
+        auto positions = buffer.frame.positions();
+        for (size_t a = 0; a < positions.size(); ++a) {
+            positions[a] = chemfiles::Vector3D(scratch[3 * a], scratch[3 * a + 1], scratch[3 * a + 2]);
+        }
+    } else {
+        buffer.frame = chemfiles_trajectory().read_step(i);
+        buffer.topology = topology;
+        buffer.index = i;
+        return;
+    }
+
+    if (cell[0] > 0) {
+        buffer.frame.set_cell(chemfiles::UnitCell({cell[0], cell[1], cell[2]}, {cell[3], cell[4], cell[5]}));
+    }
+    buffer.frame.set_step(i);
+    buffer.index = i;
+}
+
+void TrajectoryHandler::read_positions(size_t i, std::span<const size_t> atoms, std::vector<float>& xyz) {
+    gather_positions(i, atoms, xyz);
+}
+
+void TrajectoryHandler::read_positions(size_t i, std::span<const size_t> atoms, std::vector<double>& xyz) {
+    gather_positions(i, atoms, xyz);
+}
+
+template <class T>
+void TrajectoryHandler::gather_positions(size_t i, std::span<const size_t> atoms, std::vector<T>& xyz) {
+    if (dcd) {
+        if (i >= n_frames) throw std::runtime_error("TrajectoryHandler: frame index out of range");
+        if (!atoms.empty() && atoms.back() >= dcd->n_atoms()) {
+            throw std::runtime_error("TrajectoryHandler: selected atom out of range");
+        }
+        // A subset touches a few pages per frame, read-ahead would fetch the rest
+        if (!atoms.empty() && !sparse_advised) {
+            dcd->advise_sparse();
+            sparse_advised = true;
+        }
+        auto x = dcd->x(i), y = dcd->y(i), z = dcd->z(i);
+        size_t n = atoms.empty() ? dcd->n_atoms() : atoms.size();
+        xyz.resize(3 * n);
+        for (size_t k = 0; k < n; ++k) {
+            size_t a = atoms.empty() ? k : atoms[k];
+            xyz[3 * k] = x[a];
+            xyz[3 * k + 1] = y[a];
+            xyz[3 * k + 2] = z[a];
+        }
+        return;
+    }
+
+    if (index) {
+        parse_positions(read_text(i), format, atoms, xyz);
+        return;
+    }
+
+    // Other formats: through chemfiles, then gathered
+    auto frame = chemfiles_trajectory().read_step(i);
+    auto positions = frame.positions();
+    if (!atoms.empty() && atoms.back() >= positions.size()) {
+        throw std::runtime_error("TrajectoryHandler: selected atom out of range");
+    }
+    size_t n = atoms.empty() ? positions.size() : atoms.size();
+    xyz.resize(3 * n);
+    for (size_t k = 0; k < n; ++k) {
+        const auto& position = positions[atoms.empty() ? k : atoms[k]];
+        for (int d = 0; d < 3; ++d) xyz[3 * k + d] = static_cast<T>(position[d]);
+    }
 }
\ No newline at end of file
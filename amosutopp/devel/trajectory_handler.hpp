@@ -2,17 +2,99 @@
 #define TRAJECTORY_HANDLER_HPP
 
 #include <chemfiles.hpp>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "dcd_reader.hpp"
+#include "frame_index.hpp"
+#include "topology_cache.hpp"
+
+// Storage reused from frame to frame by TrajectoryHandler::read_into. The
+// positions are overwritten in place and the topology is attached once, when
+// the size changes, so steady-state reads of DCD and indexed text frames do
+// not allocate. Attaching copies the whole topology into the frame: each
+// buffer (each prefetcher slot, too) holds its own copy, made once per buffer
+// rather than once per frame.
+struct FrameBuffer {
+    chemfiles::Frame frame;
+    size_t index = 0;
+    // The one last copied into the frame, held so that its address cannot be
+    // reused by another topology while the buffer compares against it
+    std::shared_ptr<const chemfiles::Topology> topology;
+
+    // Sizes the frame for n_atoms and copies `topology` into it, unless already done
+    void attach(const std::shared_ptr<const chemfiles::Topology>& topology, size_t n_atoms);
+};
 
 class TrajectoryHandler {
 public:
     TrajectoryHandler(const std::string& trajectory_file, const std::string& topology_file);
 
+    // With a topology that is already loaded, e.g. from broadcast_topology()
+    TrajectoryHandler(const std::string& trajectory_file, TopologyCache topology_cache);
+
+    // Handle for read_positions only, as load_trajectory opens one per thread:
+    // only the DCD mapping or the frame index is opened, with no chemfiles
+    // topology, and a chemfiles trajectory only for the other formats.
+    // read_frame and read_into throw on it. Readers of one text trajectory
+    // can share a frame index opened once, instead of each loading it.
+    static TrajectoryHandler positions_only(const std::string& trajectory_file,
+                                            std::shared_ptr<const FrameIndex> index = nullptr);
+
     size_t get_n_frames() const;
     chemfiles::Frame read_frame(size_t i);
 
+    // Frame i into reused storage. Formats without a native reader go
+    // through chemfiles, which returns a new frame (and allocates) every time
+    void read_into(size_t i, FrameBuffer& buffer);
+
+    // Positions of the selected atoms of frame i (sorted indices, empty for
+    // every atom) as x, y, z per atom, without building a chemfiles frame
+    // where the format allows it: DCD values are gathered from the mapping,
+    // and indexed text frames only convert the selected lines. Into doubles,
+    // text and chemfiles positions keep their full precision; DCD files store
+    // single precision, which is widened exactly.
+    void read_positions(size_t i, std::span<const size_t> atoms, std::vector<float>& xyz);
+    void read_positions(size_t i, std::span<const size_t> atoms, std::vector<double>& xyz);
+
+    // Zero-copy float views of DCD trajectories, nullptr for other formats
+    // (or DCD variants the native reader does not handle)
+    const DCDReader* native_dcd() const { return dcd.get(); }
+
+    // Per-atom topology arrays, from the binary cache of the data file
+    const TopologyCache& topology_arrays() const { return topology_cache; }
+
+    // Frame offsets of XYZ / LAMMPS dump trajectories, nullptr for other formats
+    const FrameIndex* frame_index() const { return index.get(); }
+
 private:
-    chemfiles::Trajectory trajectory;
-    size_t n_frames;
+    TrajectoryHandler() = default;
+    void open(const std::string& trajectory_file);
+    std::string_view read_text(size_t i);  // byte range of an indexed frame
+    chemfiles::Trajectory& chemfiles_trajectory();  // opened on first use
+
+    template <class T>
+    void gather_positions(size_t i, std::span<const size_t> atoms, std::vector<T>& xyz);
+
+    std::string path;
+    std::unique_ptr<chemfiles::Trajectory> trajectory;  // only for formats without a native reader, or read_frame on DCD
+    size_t n_frames = 0;
+    bool with_topology = true;  // false for positions_only handles
+    std::unique_ptr<DCDReader> dcd;
+    bool sparse_advised = false;
+    TopologyCache topology_cache;
+    std::shared_ptr<const chemfiles::Topology> topology;  // rebuilt once from the cache
+
+    // Indexed text trajectories: frame i is read from its byte range with a
+    // chemfiles memory reader
+    std::shared_ptr<const FrameIndex> index;
+    std::string format;
+    std::ifstream text;
+    std::string frame_text;
+    std::vector<double> scratch;  // positions of indexed frames, before they go to a FrameBuffer
 };
 
 #endif // TRAJECTORY_HANDLER_HPP
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "trajectory_tensor.hpp"
+#include "trajectory_handler.hpp"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <omp.h>
+#include <string>
+#include <vector>
+
+TrajectoryTensor::TrajectoryTensor(size_t n_frames, size_t n_atoms, DType dtype)
+    : frames(n_frames), atoms(n_atoms), type(dtype),
+      storage(new unsigned char[n_frames * n_atoms * 3 * (dtype == DType::Float32 ? sizeof(float) : sizeof(double))]) {}
+
+namespace {
+
+// Frames [first, last) of `frames` into their rows of `out`, each decoded in
+// the tensor's element type into a reused buffer, then copied to its row
+template <class T>
+void read_block(TrajectoryHandler& reader, std::span<const size_t> frames, size_t first, size_t last,
+                std::span<const size_t> atoms, size_t n_atoms, T* out) {
+    size_t row = 3 * n_atoms;
+    std::vector<T> xyz;
+    for (size_t k = first; k < last; ++k) {
+        reader.read_positions(frames[k], atoms, xyz);
+        if (xyz.size() != row) {
+            throw std::runtime_error("load_trajectory: frame " + std::to_string(frames[k]) +
+                                     " does not have " + std::to_string(n_atoms) + " atoms");
+        }
+        std::copy(xyz.begin(), xyz.end(), out + k * row);
+    }
+}
+
+}
+
+TrajectoryTensor load_trajectory(const std::string& trajectory_file, const TopologyCache& topology,
+                                 std::span<const size_t> frames, std::span<const size_t> atoms,
+                                 TrajectoryTensor::DType dtype, int n_readers) {
+    size_t n_atoms = atoms.empty() ? topology.n_atoms() : atoms.size();
+    TrajectoryTensor tensor(frames.size(), n_atoms, dtype);
+    if (frames.empty()) return tensor;
+
+    if (n_readers <= 0) n_readers = omp_get_max_threads();
+    n_readers = static_cast<int>(std::min<size_t>(n_readers, frames.size()));
+
+    // Text trajectories are indexed here, once, rather than by every reader
+    // at the same time; the readers share the index
+    std::shared_ptr<const FrameIndex> index;
+    std::string format = FrameIndex::format_of(trajectory_file);
+    if (!format.empty()) index = std::make_shared<const FrameIndex>(FrameIndex::open(trajectory_file, format));
+
+    // Blocks split by hand rather than with omp for, so a reader that fails
+    // to open does not leave the others waiting at a barrier
+    std::exception_ptr error;
+    #pragma omp parallel num_threads(n_readers)
+    {
+        size_t n = static_cast<size_t>(omp_get_num_threads()), t = static_cast<size_t>(omp_get_thread_num());
+        size_t first = frames.size() * t / n, last = frames.size() * (t + 1) / n;
+        try {
+            // One handle per reader, with its own file position and mapping
+            TrajectoryHandler reader = TrajectoryHandler::positions_only(trajectory_file, index);
+            if (dtype == TrajectoryTensor::DType::Float32) {
+                read_block(reader, frames, first, last, atoms, n_atoms, tensor.view<float>().data_handle());
+            } else {
+                read_block(reader, frames, first, last, atoms, n_atoms, tensor.view<double>().data_handle());
+            }
+        } catch (...) {
+            #pragma omp critical
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    return tensor;
+}
@@ -0,0 +1,70 @@
+#ifndef TRAJECTORY_TENSOR_HPP
+#define TRAJECTORY_TENSOR_HPP
+
+#include <cstddef>
+#include <experimental/mdspan>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "topology_cache.hpp"
+
+template <class T>
+using TensorView = std::experimental::mdspan<T, std::experimental::dextents<size_t, 3>>;
+
+// Positions of many frames in one allocation, frames x atoms x 3, in float
+// or double. The storage is left uninitialised: each page is first written
+// by the thread that decodes into it, so on NUMA machines it is placed on
+// that thread's node.
+class TrajectoryTensor {
+public:
+    enum class DType { Float32, Float64 };
+
+    TrajectoryTensor() = default;
+    TrajectoryTensor(size_t n_frames, size_t n_atoms, DType dtype);
+
+    size_t n_frames() const { return frames; }
+    size_t n_atoms() const { return atoms; }
+    DType dtype() const { return type; }
+
+    // (frame, atom, xyz) views; T must match the dtype
+    template <class T>
+    TensorView<T> view() {
+        check<T>();
+        return TensorView<T>(reinterpret_cast<T*>(storage.get()), frames, atoms, 3);
+    }
+
+    template <class T>
+    TensorView<const T> view() const {
+        check<T>();
+        return TensorView<const T>(reinterpret_cast<const T*>(storage.get()), frames, atoms, 3);
+    }
+
+private:
+    template <class T>
+    void check() const {
+        static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "TrajectoryTensor holds float or double");
+        if ((type == DType::Float32) != std::is_same_v<T, float>) {
+            throw std::runtime_error("TrajectoryTensor: view type does not match the dtype");
+        }
+    }
+
+    size_t frames = 0, atoms = 0;
+    DType type = DType::Float32;
+    std::unique_ptr<unsigned char[]> storage;
+};
+
+// Positions of `frames` for the selected `atoms` (sorted indices, empty for
+// every atom), decoded in parallel: each of `n_readers` threads (0: as many
+// as OpenMP provides) opens its own positions-only handle on the trajectory
+// and decodes a contiguous block of frames, one frame at a time into a reused
+// buffer that is then copied to the frame's row of the tensor. Text
+// trajectories are indexed once, before the readers start. Float64 keeps the
+// full precision of text and chemfiles positions; DCD files only hold single
+// precision. `topology` gives the atom count.
+TrajectoryTensor load_trajectory(const std::string& trajectory_file, const TopologyCache& topology,
+                                 std::span<const size_t> frames, std::span<const size_t> atoms,
+                                 TrajectoryTensor::DType dtype = TrajectoryTensor::DType::Float32, int n_readers = 0);
+
+#endif // TRAJECTORY_TENSOR_HPP
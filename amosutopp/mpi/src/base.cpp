@@ -1,6 +1,109 @@
 #include "base.hpp"
+#include "utils/parallel.hpp"
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
+
+namespace {
+
+    // Flat image of a topology, as the LAMMPS data reader fills it: for each
+    // atom its mass, charge, name and type, then the bonds, then the residues
+    // (name, optional id, atoms). Counts are 64-bit, strings length-prefixed
+    struct ImageWriter {
+        std::vector<char> bytes;
+
+        template <class T>
+        void put(T value) {
+            const char* p = reinterpret_cast<const char*>(&value);
+            bytes.insert(bytes.end(), p, p + sizeof(T));
+        }
+        void put(const std::string& text) {
+            put<uint64_t>(text.size());
+            bytes.insert(bytes.end(), text.begin(), text.end());
+        }
+    };
+
+    struct ImageReader {
+        const char* cursor;
+
+        template <class T>
+        T get() {
+            T value;
+            std::memcpy(&value, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return value;
+        }
+        std::string get_string() {
+            size_t size = get<uint64_t>();
+            std::string text(cursor, size);
+            cursor += size;
+            return text;
+        }
+    };
+
+    std::vector<char> flatten(const chemfiles::Topology& topology) {
+        ImageWriter out;
+        out.put<uint64_t>(topology.size());
+        for (size_t i = 0; i < topology.size(); ++i) {
+            const chemfiles::Atom& atom = topology[i];
+            out.put(atom.mass());
+            out.put(atom.charge());
+            out.put(atom.name());
+            out.put(atom.type());
+        }
+        const auto& bonds = topology.bonds();
+        out.put<uint64_t>(bonds.size());
+        for (const auto& bond : bonds) {
+            out.put<uint64_t>(bond[0]);
+            out.put<uint64_t>(bond[1]);
+        }
+        const auto& residues = topology.residues();
+        out.put<uint64_t>(residues.size());
+        for (const auto& residue : residues) {
+            out.put(residue.name());
+            auto id = residue.id();
+            out.put<uint8_t>(id ? 1 : 0);
+            out.put<int64_t>(id ? *id : 0);
+            out.put<uint64_t>(residue.size());
+            for (size_t atom : residue) out.put<uint64_t>(atom);
+        }
+        return std::move(out.bytes);
+    }
+
+    chemfiles::Topology unflatten(const char* image) {
+        ImageReader in{image};
+        chemfiles::Topology topology;
+        size_t n_atoms = in.get<uint64_t>();
+        for (size_t i = 0; i < n_atoms; ++i) {
+            double mass = in.get<double>();
+            double charge = in.get<double>();
+            std::string name = in.get_string();
+            chemfiles::Atom atom(name, in.get_string());
+            atom.set_mass(mass);
+            atom.set_charge(charge);
+            topology.add_atom(std::move(atom));
+        }
+        size_t n_bonds = in.get<uint64_t>();
+        for (size_t b = 0; b < n_bonds; ++b) {
+            size_t i = in.get<uint64_t>();
+            topology.add_bond(i, in.get<uint64_t>());
+        }
+        size_t n_residues = in.get<uint64_t>();
+        for (size_t r = 0; r < n_residues; ++r) {
+            std::string name = in.get_string();
+            bool has_id = in.get<uint8_t>() != 0;
+            int64_t id = in.get<int64_t>();
+            chemfiles::Residue residue = has_id ? chemfiles::Residue(name, id) : chemfiles::Residue(name);
+            size_t n_members = in.get<uint64_t>();
+            for (size_t k = 0; k < n_members; ++k) residue.add_atom(in.get<uint64_t>());
+            topology.add_residue(std::move(residue));
+        }
+        return topology;
+    }
+
+}
 
 // Base::Base() : base_args{}, trajectory(nullptr), mpi_rank(0), mpi_size(1) {}
 Base::Base() : base_args{}, trajectory(nullptr) {}
@@ -8,7 +111,7 @@ Base::Base() : base_args{}, trajectory(nullptr) {}
 Base::~Base() {}
 
 void Base::parse_common_args(CLI::App& app) {
-    // app.add_option("--topo", base_args.topo, "Topology file")->required()->check(CLI::ExistingFile);
+    app.add_option("--topo", base_args.topo, "Topology file (LAMMPS data)")->check(CLI::ExistingFile);
     app.add_option("--traj", base_args.traj, "Trajectory file")->required()->check(CLI::ExistingFile);
 }
 
@@ -20,4 +123,32 @@ void Base::init_universe() {
     // Initialize Chemfiles trajectory
     trajectory = std::make_unique<chemfiles::Trajectory>(base_args.traj);
     // std::cout << "MPI Rank " << mpi_rank << " initialized the trajectory." << std::endl;
-}
\ No newline at end of file
+    if (base_args.topo.empty()) return;
+
+    // Under MPI only rank 0 parses the topology file. The parsed topology
+    // travels as a flat image through a node-shared window, freed as soon as
+    // every rank has rebuilt its own chemfiles::Topology from it; unlike
+    // devel's broadcast_topology, ranks do not share one copy per node
+    int mpi_initialized = 0;
+    MPI_Initialized(&mpi_initialized);
+    if (!mpi_initialized) {
+        trajectory->set_topology(base_args.topo, "LAMMPS Data");
+        return;
+    }
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    std::vector<char> image;
+    bool parsed = false;
+    if (rank == 0) {
+        try {
+            image = flatten(chemfiles::Trajectory(base_args.topo, 'r', "LAMMPS Data").read().topology());
+            parsed = true;
+        } catch (const chemfiles::Error& error) {
+            std::cerr << "Error: " << error.what() << std::endl;
+        }
+    }
+    Parallel::SharedBuffer shared = Parallel::broadcast_bytes(parsed ? &image : nullptr, base_args.topo);
+    auto topology = unflatten(shared.data);
+    Parallel::free_shared(shared);
+    trajectory->set_topology(topology);
+}
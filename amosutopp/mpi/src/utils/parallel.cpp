@@ -1,5 +1,11 @@
 #include "parallel.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 namespace Parallel {
 
@@ -25,4 +31,57 @@ namespace Parallel {
         std::cout << "MPI Rank " << rank << " will process frames from " << start_frame << " to " << end_frame - 1 << "." << std::endl;
     }
 
-}
\ No newline at end of file
+    SharedBuffer broadcast_bytes(const std::vector<char>* contents, const std::string& what, MPI_Comm comm) {
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+
+        // Ranks sharing memory, and their leaders (local rank 0); with the rank
+        // as key, rank 0 leads its node and is rank 0 among the leaders
+        MPI_Comm node, leaders;
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+        int node_rank;
+        MPI_Comm_rank(node, &node_rank);
+        MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leaders);
+
+        uint64_t size = 0;
+        if (rank == 0) size = contents ? contents->size() : UINT64_MAX;  // every rank throws below
+        MPI_Bcast(&size, 1, MPI_UINT64_T, 0, comm);
+        if (size == UINT64_MAX) {
+            MPI_Comm_free(&node);
+            if (leaders != MPI_COMM_NULL) MPI_Comm_free(&leaders);
+            throw std::runtime_error("Error: cannot read " + what);
+        }
+
+        SharedBuffer buffer;
+        char* base = nullptr;
+        MPI_Win_allocate_shared(node_rank == 0 ? static_cast<MPI_Aint>(size) : 0, 1, MPI_INFO_NULL, node, &base, &buffer.window);
+        if (node_rank != 0) {
+            MPI_Aint window_size;
+            int displacement;
+            MPI_Win_shared_query(buffer.window, 0, &window_size, &displacement, &base);
+        }
+
+        MPI_Win_fence(0, buffer.window);
+        if (leaders != MPI_COMM_NULL) {
+            if (rank == 0 && size > 0) std::memcpy(base, contents->data(), size);
+            for (uint64_t offset = 0; offset < size; offset += INT_MAX) {
+                int count = static_cast<int>(std::min<uint64_t>(size - offset, INT_MAX));
+                MPI_Bcast(base + offset, count, MPI_BYTE, 0, leaders);
+            }
+            MPI_Comm_free(&leaders);
+        }
+        MPI_Win_fence(0, buffer.window);
+        MPI_Comm_free(&node);
+
+        buffer.data = base;
+        buffer.size = size;
+        return buffer;
+    }
+
+    void free_shared(SharedBuffer& buffer) {
+        if (buffer.window != MPI_WIN_NULL) MPI_Win_free(&buffer.window);
+        buffer.data = nullptr;
+        buffer.size = 0;
+    }
+
+}
@@ -2,6 +2,9 @@
 #define PARALLEL_HPP
 
 #include <mpi.h>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 namespace Parallel {
 
@@ -14,6 +17,22 @@ namespace Parallel {
     // Distribute trajectory frames among MPI ranks
     void distribute_frames(int rank, int size, size_t total_frames, size_t& start_frame, size_t& end_frame);
 
+    // Read-only bytes shared by all ranks of a node through an MPI shared-memory window
+    struct SharedBuffer {
+        const char* data = nullptr;
+        size_t size = 0;
+        MPI_Win window = MPI_WIN_NULL;
+    };
+
+    // Bytes rank 0 built in memory (`contents` is ignored elsewhere), sent to
+    // one rank per node, which fills the node's shared window. Rank 0 passes
+    // nullptr when it could not build them, and every rank then throws,
+    // naming `what`. Collective over comm
+    SharedBuffer broadcast_bytes(const std::vector<char>* contents, const std::string& what, MPI_Comm comm = MPI_COMM_WORLD);
+
+    // Collective over the ranks of the node
+    void free_shared(SharedBuffer& buffer);
+
 }
 
 #endif // PARALLEL_HPP
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "collective_msd.hpp"
+#include "correlation.hpp"
+#include <complex>
+#include <stdexcept>
+#include <utility>
+#include <omp.h>
+
+CollectiveMSD::CollectiveMSD(const chemfiles::Topology& topology, size_t n_frames)
+    : n_frames(n_frames), species(topology.size()), charges(topology.size()) {
+    // Species are atom types, numbered in order of first appearance
+    for (size_t i = 0; i < topology.size(); ++i) {
+        const auto& type = topology[i].type();
+        size_t a = 0;
+        while (a < names.size() && names[a] != type) ++a;
+        if (a == names.size()) names.push_back(type);
+
+        species[i] = a;
+        charges[i] = topology[i].charge();
+    }
+
+    series.assign(names.size() * 3 * n_frames, 0.0);
+}
+
+size_t CollectiveMSD::pair_index(size_t a, size_t b) const {
+    if (a > b) std::swap(a, b);
+    size_t n = names.size();
+    return a * n - a * (a - 1) / 2 + (b - a);
+}
+
+void CollectiveMSD::add_frame(size_t frame_index, const chemfiles::Frame& frame) {
+    if (frame.size() != species.size()) {
+        throw std::runtime_error("Frame size does not match the topology");
+    }
+
+    std::vector<double> collective(names.size() * 3, 0.0);
+    auto positions = frame.positions();
+    for (size_t i = 0; i < species.size(); ++i) {
+        double* m = &collective[species[i] * 3];
+        m[0] += charges[i] * positions[i][0];
+        m[1] += charges[i] * positions[i][1];
+        m[2] += charges[i] * positions[i][2];
+    }
+
+    for (size_t c = 0; c < collective.size(); ++c) {
+        series[c * n_frames + frame_index] = collective[c];
+    }
+}
+
+void CollectiveMSD::allreduce(MPI_Comm comm) {
+    // Every rank left zeros outside its own frames, so a sum assembles the series
+    MPI_Allreduce(MPI_IN_PLACE, series.data(), static_cast<int>(series.size()), MPI_DOUBLE, MPI_SUM, comm);
+}
+
+std::vector<std::vector<double>> CollectiveMSD::compute(size_t max_lag) const {
+    size_t n = names.size();
+    size_t n_pairs = n * (n + 1) / 2;
+    if (max_lag > n_frames) max_lag = n_frames;
+
+    std::vector<std::vector<double>> pairs(n_pairs, std::vector<double>(max_lag, 0.0));
+
+    // Only a handful of pairs x 3 components: thread over them
+    #pragma omp parallel
+    {
+        std::vector<double> msd;
+        std::vector<std::complex<double>> work;
+
+        #pragma omp for collapse(2) schedule(dynamic)
+        for (size_t a = 0; a < n; ++a) {
+            for (size_t b = 0; b < n; ++b) {
+                if (b < a) continue;
+                std::vector<double>& out = pairs[pair_index(a, b)];
+                for (size_t d = 0; d < 3; ++d) {
+                    msd_fft(&series[(a * 3 + d) * n_frames], &series[(b * 3 + d) * n_frames],
+                            n_frames, max_lag, msd, work);
+                    for (size_t k = 0; k < max_lag; ++k) out[k] += msd[k];
+                }
+            }
+        }
+    }
+
+    return pairs;
+}
+
+std::vector<double> CollectiveMSD::total(const std::vector<std::vector<double>>& pairs) const {
+    std::vector<double> sum(pairs[0].size(), 0.0);
+    for (size_t a = 0; a < names.size(); ++a) {
+        for (size_t b = a; b < names.size(); ++b) {
+            double weight = (a == b) ? 1.0 : 2.0;
+            const std::vector<double>& msd = pairs[pair_index(a, b)];
+            for (size_t k = 0; k < sum.size(); ++k) sum[k] += weight * msd[k];
+        }
+    }
+    return sum;
+}
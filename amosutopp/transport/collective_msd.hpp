@@ -0,0 +1,41 @@
+#ifndef COLLECTIVE_MSD_HPP
+#define COLLECTIVE_MSD_HPP
+
+#include <chemfiles.hpp>
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+// Einstein-Helfand MSD of the charge-weighted translation of each species,
+// M_a(t) = sum_{i in a} q_i r_i(t), and of their cross terms. Each frame is
+// reduced to n_species vectors while streaming, so memory is O(frames).
+// Positions must be unwrapped.
+class CollectiveMSD {
+public:
+    CollectiveMSD(const chemfiles::Topology& topology, size_t n_frames);
+
+    // Reduce frame `frame_index` to its collective vectors
+    void add_frame(size_t frame_index, const chemfiles::Frame& frame);
+
+    // Sum the frame slices filled by every rank of `comm`
+    void allreduce(MPI_Comm comm);
+
+    // <dM_a . dM_b> for every species pair a <= b, packed by pair_index()
+    std::vector<std::vector<double>> compute(size_t max_lag) const;
+
+    // Total charge MSD: sum_a MSD_aa + 2 sum_{a<b} MSD_ab
+    std::vector<double> total(const std::vector<std::vector<double>>& pairs) const;
+
+    size_t n_species() const { return names.size(); }
+    const std::string& species_name(size_t a) const { return names[a]; }
+    size_t pair_index(size_t a, size_t b) const;
+
+private:
+    size_t n_frames;
+    std::vector<size_t> species;        // species index of every atom
+    std::vector<double> charges;        // charge of every atom
+    std::vector<std::string> names;     // atom type of every species
+    std::vector<double> series;         // (species, dim)-major, n_species x 3 x n_frames
+};
+
+#endif // COLLECTIVE_MSD_HPP
@@ -1,2 +1,6 @@
-# g++ -fopenmp -mavx2 -O3 -funroll-loops -o msd msd.cpp
-g++ -mavx2 -O3 -funroll-loops -o msd msd.cpp
\ No newline at end of file
+# g++ -fopenmp -mavx2 -O3 -funroll-loops -o msd main_msd.cpp msd.cpp correlation.cpp
+g++ -fopenmp -mavx2 -O3 -funroll-loops -o msd main_msd.cpp msd.cpp correlation.cpp
+# g++ -fopenmp -O3 -o transport main_transport.cpp vacf.cpp green_kubo.cpp correlation.cpp -I/usr/local/include -lchemfiles -L/usr/local/lib
+# mpicxx -fopenmp -O3 -o conductivity main_conductivity.cpp collective_msd.cpp correlation.cpp ../mpi/src/utils/parallel.cpp -I/usr/local/include -lchemfiles -L/usr/local/lib
+# mpicxx -fopenmp -O3 -march=native -o van_hove main_van_hove.cpp van_hove.cpp ../devel/analysis/histogram.cpp ../mpi/src/utils/parallel.cpp -I/usr/local/include -lchemfiles -L/usr/local/lib
+# g++ -fopenmp -O3 -march=native -o group_msd main_group_msd.cpp group_msd.cpp -I/usr/local/include -lchemfiles -L/usr/local/lib
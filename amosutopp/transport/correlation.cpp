@@ -0,0 +1,166 @@
+#include "correlation.hpp"
+#include <cmath>
+#include <utility>
+
+size_t next_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+void fft(std::vector<std::complex<double>>& data, bool inverse) {
+    size_t n = data.size();
+
+    // Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+
+    // Butterflies
+    for (size_t len = 2; len <= n; len <<= 1) {
+        double angle = 2.0 * M_PI / len * (inverse ? 1.0 : -1.0);
+        std::complex<double> wlen(std::cos(angle), std::sin(angle));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < len / 2; ++k) {
+                std::complex<double> u = data[i + k];
+                std::complex<double> v = data[i + k + len / 2] * w;
+                data[i + k] = u + v;
+                data[i + k + len / 2] = u - v;
+                w *= wlen;
+            }
+        }
+    }
+
+    if (inverse) {
+        for (auto& x : data) x /= static_cast<double>(n);
+    }
+}
+
+void autocorrelation_fft(const float* x, size_t n, size_t max_lag,
+                         std::vector<double>& out,
+                         std::vector<std::complex<double>>& work) {
+    // Pad to at least 2n so the circular correlation equals the linear one
+    size_t size = next_pow2(2 * n);
+    work.assign(size, std::complex<double>(0.0, 0.0));
+    for (size_t t = 0; t < n; ++t) work[t] = x[t];
+
+    fft(work);
+    for (auto& c : work) c = std::norm(c);
+    fft(work, true);
+
+    if (max_lag > n) max_lag = n;
+    out.resize(max_lag);
+    for (size_t k = 0; k < max_lag; ++k) {
+        out[k] = work[k].real() / (n - k);
+    }
+}
+
+void crosscorrelation_fft(const double* x, const double* y, size_t n, size_t max_lag,
+                          std::vector<double>& out,
+                          std::vector<std::complex<double>>& work) {
+    // Pack x in the real part and y in the imaginary part: one forward FFT
+    size_t size = next_pow2(2 * n);
+    work.assign(size, std::complex<double>(0.0, 0.0));
+    for (size_t t = 0; t < n; ++t) work[t] = std::complex<double>(x[t], y[t]);
+
+    fft(work);
+
+    // Unpack X and Y, then form conj(X) * Y
+    std::vector<std::complex<double>> product(size);
+    for (size_t k = 0; k < size; ++k) {
+        std::complex<double> a = work[k];
+        std::complex<double> b = std::conj(work[(size - k) % size]);
+        std::complex<double> X = 0.5 * (a + b);
+        std::complex<double> Y = std::complex<double>(0.0, -0.5) * (a - b);
+        product[k] = std::conj(X) * Y;
+    }
+    work.swap(product);
+    fft(work, true);
+
+    if (max_lag > n) max_lag = n;
+    out.resize(max_lag);
+    for (size_t k = 0; k < max_lag; ++k) {
+        out[k] = work[k].real() / (n - k);
+    }
+}
+
+void msd_fft(const double* x, const double* y, size_t n, size_t max_lag,
+             std::vector<double>& out,
+             std::vector<std::complex<double>>& work) {
+    if (max_lag > n) max_lag = n;
+
+    // <x(t+k) y(t)> and <x(t) y(t+k)>
+    std::vector<double> xy, yx;
+    crosscorrelation_fft(y, x, n, max_lag, xy, work);
+    crosscorrelation_fft(x, y, n, max_lag, yx, work);
+
+    // Prefix sums of x*y give the equal-time terms over [0, n-k) and [k, n)
+    std::vector<double> prefix(n + 1, 0.0);
+    for (size_t t = 0; t < n; ++t) prefix[t + 1] = prefix[t] + x[t] * y[t];
+
+    out.resize(max_lag);
+    for (size_t k = 0; k < max_lag; ++k) {
+        double head = prefix[n - k];
+        double tail = prefix[n] - prefix[k];
+        out[k] = (head + tail) / (n - k) - xy[k] - yx[k];
+    }
+}
+
+BlockEstimate block_estimate(const std::vector<double>& blocks) {
+    size_t n = blocks.size();
+    double mean = 0.0;
+    for (double b : blocks) mean += b;
+    mean /= n;
+
+    if (n < 2) return {mean, 0.0};
+
+    double var = 0.0;
+    for (double b : blocks) var += (b - mean) * (b - mean);
+    var /= (n - 1);
+
+    return {mean, std::sqrt(var / n)};
+}
+
+std::vector<BlockingLevel> flyvbjerg_petersen(std::vector<double> series) {
+    std::vector<BlockingLevel> levels;
+
+    while (series.size() >= 2) {
+        size_t n = series.size();
+        double mean = 0.0;
+        for (double x : series) mean += x;
+        mean /= n;
+
+        double c0 = 0.0;
+        for (double x : series) c0 += (x - mean) * (x - mean);
+        c0 /= n;
+
+        double std_error = std::sqrt(c0 / (n - 1));
+        levels.push_back({n, std_error, std_error / std::sqrt(2.0 * (n - 1))});
+
+        // Blocking transformation: average neighbouring pairs
+        for (size_t i = 0; i < n / 2; ++i) {
+            series[i] = 0.5 * (series[2 * i] + series[2 * i + 1]);
+        }
+        series.resize(n / 2);
+    }
+
+    return levels;
+}
+
+size_t blocking_plateau_level(const std::vector<BlockingLevel>& levels) {
+    for (size_t l = 0; l + 1 < levels.size(); ++l) {
+        if (levels[l + 1].std_error - levels[l].std_error < levels[l].std_error_error) {
+            return l;
+        }
+    }
+    return levels.empty() ? 0 : levels.size() - 1;
+}
+
+double blocking_plateau(const std::vector<BlockingLevel>& levels) {
+    if (levels.empty()) return 0.0;
+    return levels[blocking_plateau_level(levels)].std_error;
+}
@@ -0,0 +1,59 @@
+#ifndef CORRELATION_HPP
+#define CORRELATION_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// In-place iterative radix-2 FFT (size of the buffer must be a power of two)
+void fft(std::vector<std::complex<double>>& data, bool inverse = false);
+
+// Smallest power of two >= n
+size_t next_pow2(size_t n);
+
+// Autocorrelation C(k) = 1/(n-k) sum_t x(t) x(t+k) for k < max_lag, using
+// zero-padded FFTs. `work` is a scratch buffer reused between calls.
+void autocorrelation_fft(const float* x, size_t n, size_t max_lag,
+                         std::vector<double>& out,
+                         std::vector<std::complex<double>>& work);
+
+// Cross-correlation C(k) = 1/(n-k) sum_t x(t) y(t+k) for k < max_lag
+void crosscorrelation_fft(const double* x, const double* y, size_t n, size_t max_lag,
+                          std::vector<double>& out,
+                          std::vector<std::complex<double>>& work);
+
+// Cross displacement <(x(t+k)-x(t)) (y(t+k)-y(t))> for k < max_lag in
+// O(n log n): prefix sums of x*y plus two FFT cross-correlations. With
+// x == y this is the usual FFT mean squared displacement.
+void msd_fft(const double* x, const double* y, size_t n, size_t max_lag,
+             std::vector<double>& out,
+             std::vector<std::complex<double>>& work);
+
+// Mean and standard error of a set of independent block estimates
+struct BlockEstimate {
+    double mean;
+    double std_error;
+};
+
+BlockEstimate block_estimate(const std::vector<double>& blocks);
+
+// One level of the Flyvbjerg-Petersen blocking transformation
+struct BlockingLevel {
+    size_t n_samples;
+    double std_error;
+    double std_error_error;
+};
+
+// Standard error of the mean of a correlated series at every blocking level
+// (the series is halved by pairwise averaging until two samples remain)
+std::vector<BlockingLevel> flyvbjerg_petersen(std::vector<double> series);
+
+// First level where the standard error stops growing within its own
+// uncertainty (last level if no plateau is reached); level l averages
+// blocks of 2^l samples
+size_t blocking_plateau_level(const std::vector<BlockingLevel>& levels);
+
+// Standard error at that level
+double blocking_plateau(const std::vector<BlockingLevel>& levels);
+
+#endif // CORRELATION_HPP
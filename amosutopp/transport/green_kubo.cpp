@@ -0,0 +1,79 @@
+#include "green_kubo.hpp"
+#include "correlation.hpp"
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+#include <omp.h>
+
+BlockACF::BlockACF(size_t n_series, size_t block_length, size_t max_lag)
+    : series(n_series), block_length(block_length), lags(std::min(max_lag, block_length)),
+      frame_in_block(0), buffer(n_series * block_length, 0.0f) {
+    if (n_series == 0 || block_length < 2) {
+        throw std::runtime_error("BlockACF needs at least one series and a block length of 2 frames");
+    }
+}
+
+void BlockACF::end_frame() {
+    if (++frame_in_block == block_length) {
+        correlate_block();
+        frame_in_block = 0;
+    }
+}
+
+void BlockACF::correlate_block() {
+    std::vector<double> block_acf(lags, 0.0);
+
+    #pragma omp parallel
+    {
+        // Thread-private accumulator and FFT scratch, merged once at the end
+        std::vector<double> local(lags, 0.0);
+        std::vector<double> acf;
+        std::vector<std::complex<double>> work;
+
+        #pragma omp for schedule(static)
+        for (size_t s = 0; s < series; ++s) {
+            autocorrelation_fft(&buffer[s * block_length], block_length, lags, acf, work);
+            for (size_t k = 0; k < lags; ++k) local[k] += acf[k];
+        }
+
+        #pragma omp critical
+        for (size_t k = 0; k < lags; ++k) block_acf[k] += local[k];
+    }
+
+    for (auto& c : block_acf) c /= series;
+    blocks.push_back(std::move(block_acf));
+}
+
+GreenKuboResult green_kubo(const std::vector<std::vector<double>>& block_acfs, double dt, double prefactor) {
+    if (block_acfs.empty()) {
+        throw std::runtime_error("Green-Kubo integral needs at least one completed block");
+    }
+
+    size_t n_blocks = block_acfs.size();
+    size_t n_lags = block_acfs[0].size();
+
+    GreenKuboResult result;
+    result.acf.assign(n_lags, 0.0);
+    result.integral.assign(n_lags, 0.0);
+    result.error.assign(n_lags, 0.0);
+
+    // Running integral of each block, kept per block to estimate the spread
+    std::vector<double> running(n_blocks, 0.0);
+    std::vector<double> values(n_blocks);
+
+    for (size_t k = 0; k < n_lags; ++k) {
+        for (size_t b = 0; b < n_blocks; ++b) {
+            if (k > 0) {
+                running[b] += 0.5 * dt * (block_acfs[b][k - 1] + block_acfs[b][k]);
+            }
+            values[b] = prefactor * running[b];
+            result.acf[k] += block_acfs[b][k] / n_blocks;
+        }
+
+        BlockEstimate estimate = block_estimate(values);
+        result.integral[k] = estimate.mean;
+        result.error[k] = estimate.std_error;
+    }
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef GREEN_KUBO_HPP
+#define GREEN_KUBO_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Streaming block autocorrelation of many scalar time series (velocity
+// components, stress or heat-flux components). Frames are pushed one at a
+// time; every `block_length` frames the block is correlated with FFTs,
+// threaded over series, and its buffer is reused for the next block.
+class BlockACF {
+public:
+    BlockACF(size_t n_series, size_t block_length, size_t max_lag);
+
+    // Slot of the current frame for series s (call end_frame() when filled)
+    float& value(size_t s) { return buffer[s * block_length + frame_in_block]; }
+
+    // Close the current frame, correlating the block when it is full
+    void end_frame();
+
+    size_t n_series() const { return series; }
+    size_t n_blocks() const { return blocks.size(); }
+    size_t max_lag() const { return lags; }
+
+    // ACF of each completed block, averaged over all series
+    const std::vector<std::vector<double>>& block_acfs() const { return blocks; }
+
+private:
+    void correlate_block();
+
+    size_t series;
+    size_t block_length;
+    size_t lags;
+    size_t frame_in_block;
+    std::vector<float> buffer;                  // series-major, n_series x block_length
+    std::vector<std::vector<double>> blocks;    // one averaged ACF per block
+};
+
+// Green-Kubo running integral with its standard error across blocks
+struct GreenKuboResult {
+    std::vector<double> acf;        // block-averaged ACF
+    std::vector<double> integral;   // prefactor * int_0^t ACF
+    std::vector<double> error;      // standard error of the running integral
+};
+
+// Trapezoidal running integral of each block ACF, reduced to mean and error
+GreenKuboResult green_kubo(const std::vector<std::vector<double>>& block_acfs, double dt, double prefactor);
+
+#endif // GREEN_KUBO_HPP
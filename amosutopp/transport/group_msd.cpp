@@ -0,0 +1,185 @@
+#include "group_msd.hpp"
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <omp.h>
+
+Groups species_groups(const chemfiles::Topology& topology) {
+    Groups groups;
+    groups.of_atom.resize(topology.size());
+
+    for (size_t i = 0; i < topology.size(); ++i) {
+        const auto& type = topology[i].type();
+        size_t g = 0;
+        while (g < groups.names.size() && groups.names[g] != type) ++g;
+        if (g == groups.names.size()) groups.names.push_back(type);
+        groups.of_atom[i] = g;
+    }
+    return groups;
+}
+
+Groups molecule_groups(const chemfiles::Topology& topology) {
+    size_t n_atoms = topology.size();
+
+    // Union-find over the bonds
+    std::vector<size_t> parent(n_atoms);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    for (const auto& bond : topology.bonds()) {
+        size_t a = find(bond[0]);
+        size_t b = find(bond[1]);
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+
+    // Number molecules in order of their first atom
+    Groups groups;
+    groups.of_atom.assign(n_atoms, Groups::NO_GROUP);
+    std::vector<size_t> molecule_of_root(n_atoms, Groups::NO_GROUP);
+    for (size_t i = 0; i < n_atoms; ++i) {
+        size_t root = find(i);
+        if (molecule_of_root[root] == Groups::NO_GROUP) {
+            molecule_of_root[root] = groups.names.size();
+            groups.names.push_back("mol" + std::to_string(groups.names.size() + 1));
+        }
+        groups.of_atom[i] = molecule_of_root[root];
+    }
+    return groups;
+}
+
+Groups read_index_groups(const std::string& path, size_t n_atoms) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open index file " + path);
+    }
+
+    Groups groups;
+    groups.of_atom.assign(n_atoms, Groups::NO_GROUP);
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t open = line.find('[');
+        if (open != std::string::npos) {
+            size_t close = line.find(']', open);
+            std::istringstream name(line.substr(open + 1, close - open - 1));
+            groups.names.emplace_back();
+            name >> groups.names.back();
+            continue;
+        }
+        if (groups.names.empty()) continue;
+
+        std::istringstream indices(line);
+        size_t index;
+        while (indices >> index) {
+            if (index == 0 || index > n_atoms) {
+                throw std::runtime_error("Atom index " + std::to_string(index) + " out of range in " + path);
+            }
+            size_t& g = groups.of_atom[index - 1];
+            if (g != Groups::NO_GROUP && g != groups.names.size() - 1) {
+                throw std::runtime_error("Atom " + std::to_string(index) + " belongs to several index groups");
+            }
+            g = groups.names.size() - 1;
+        }
+    }
+    return groups;
+}
+
+GroupMSD::GroupMSD(const Groups& groups, const chemfiles::Topology& topology, size_t max_lag, bool remove_drift)
+    : groups(groups), masses(topology.size()), group_size(groups.names.size(), 0),
+      n_atoms(topology.size()), max_lag(max_lag), remove_drift(remove_drift), frames_seen(0),
+      ring((max_lag + 1) * 3 * topology.size(), 0.0f) {
+    if (groups.of_atom.size() != n_atoms) {
+        throw std::runtime_error("Groups do not match the topology size");
+    }
+
+    for (size_t i = 0; i < n_atoms; ++i) {
+        masses[i] = topology[i].mass();
+        if (groups.of_atom[i] != Groups::NO_GROUP) group_size[groups.of_atom[i]]++;
+    }
+
+    // Persistent per-thread accumulators, merged only in compute()
+    size_t n_groups = groups.names.size();
+    partial.assign(omp_get_max_threads(), std::vector<double>((max_lag + 1) * n_groups, 0.0));
+}
+
+void GroupMSD::add_frame(const chemfiles::Frame& frame) {
+    if (frame.size() != n_atoms) {
+        throw std::runtime_error("Frame size does not match the topology");
+    }
+
+    auto positions = frame.positions();
+    size_t n_slots = max_lag + 1;
+    float* slot = &ring[(frames_seen % n_slots) * 3 * n_atoms];
+
+    // Centre of mass of the whole system, subtracted to remove the drift
+    double com[3] = {0.0, 0.0, 0.0};
+    if (remove_drift) {
+        double total_mass = 0.0;
+        for (size_t i = 0; i < n_atoms; ++i) {
+            com[0] += masses[i] * positions[i][0];
+            com[1] += masses[i] * positions[i][1];
+            com[2] += masses[i] * positions[i][2];
+            total_mass += masses[i];
+        }
+        if (total_mass > 0.0) {
+            for (double& c : com) c /= total_mass;
+        }
+    }
+
+    for (size_t i = 0; i < n_atoms; ++i) {
+        slot[i] = static_cast<float>(positions[i][0] - com[0]);
+        slot[n_atoms + i] = static_cast<float>(positions[i][1] - com[1]);
+        slot[2 * n_atoms + i] = static_cast<float>(positions[i][2] - com[2]);
+    }
+
+    size_t n_lags = std::min(frames_seen, max_lag);
+    size_t n_groups = groups.names.size();
+
+    #pragma omp parallel num_threads(static_cast<int>(partial.size()))
+    {
+        std::vector<double>& acc = partial[omp_get_thread_num()];
+
+        #pragma omp for schedule(static)
+        for (size_t i = 0; i < n_atoms; ++i) {
+            size_t g = groups.of_atom[i];
+            if (g == Groups::NO_GROUP) continue;
+
+            for (size_t tau = 1; tau <= n_lags; ++tau) {
+                const float* old = &ring[((frames_seen - tau) % n_slots) * 3 * n_atoms];
+                float dx = slot[i] - old[i];
+                float dy = slot[n_atoms + i] - old[n_atoms + i];
+                float dz = slot[2 * n_atoms + i] - old[2 * n_atoms + i];
+                acc[tau * n_groups + g] += dx * dx + dy * dy + dz * dz;
+            }
+        }
+    }
+
+    frames_seen++;
+}
+
+std::vector<std::vector<double>> GroupMSD::compute() const {
+    size_t n_groups = groups.names.size();
+    std::vector<std::vector<double>> msd(n_groups, std::vector<double>(max_lag + 1, 0.0));
+
+    for (const auto& acc : partial) {
+        for (size_t tau = 1; tau <= max_lag; ++tau) {
+            for (size_t g = 0; g < n_groups; ++g) msd[g][tau] += acc[tau * n_groups + g];
+        }
+    }
+
+    // Every lag tau was sampled from frames_seen - tau time origins
+    for (size_t g = 0; g < n_groups; ++g) {
+        for (size_t tau = 1; tau <= max_lag; ++tau) {
+            double samples = static_cast<double>(group_size[g]) * (frames_seen > tau ? frames_seen - tau : 0);
+            msd[g][tau] = samples > 0.0 ? msd[g][tau] / samples : 0.0;
+        }
+    }
+    return msd;
+}
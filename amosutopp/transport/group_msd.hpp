@@ -0,0 +1,57 @@
+#ifndef GROUP_MSD_HPP
+#define GROUP_MSD_HPP
+
+#include <chemfiles.hpp>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Disjoint atom groups: group index of every atom (NO_GROUP if unused)
+struct Groups {
+    static constexpr size_t NO_GROUP = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> of_atom;
+    std::vector<std::string> names;
+};
+
+// One group per atom type
+Groups species_groups(const chemfiles::Topology& topology);
+
+// One group per molecule, found from the bond connectivity
+Groups molecule_groups(const chemfiles::Topology& topology);
+
+// User index groups from a GROMACS-style index file ("[ name ]" followed by
+// 1-based atom indices); groups must not overlap
+Groups read_index_groups(const std::string& path, size_t n_atoms);
+
+// Group-averaged MSD accumulated while streaming: the last max_lag frames
+// are kept in a ring buffer and every new frame is compared against them,
+// so memory is O(max_lag x atoms) and the output O(max_lag x groups).
+// Positions must be unwrapped.
+class GroupMSD {
+public:
+    GroupMSD(const Groups& groups, const chemfiles::Topology& topology, size_t max_lag, bool remove_drift);
+
+    // Compare the frame with the buffered ones and add it to the ring
+    void add_frame(const chemfiles::Frame& frame);
+
+    // MSD per group, indexed [group][lag] (lag 0 is zero)
+    std::vector<std::vector<double>> compute() const;
+
+    const std::vector<std::string>& group_names() const { return groups.names; }
+
+private:
+    Groups groups;
+    std::vector<double> masses;
+    std::vector<size_t> group_size;
+    size_t n_atoms;
+    size_t max_lag;
+    bool remove_drift;
+    size_t frames_seen;
+
+    std::vector<float> ring;                    // (max_lag + 1) slots of x, y, z blocks
+    std::vector<std::vector<double>> partial;   // per-thread [lag][group] sums
+};
+
+#endif // GROUP_MSD_HPP
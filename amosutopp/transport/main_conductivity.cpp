@@ -0,0 +1,57 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <chemfiles.hpp>
+#include "collective_msd.hpp"
+#include "../mpi/src/utils/parallel.hpp"
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <trajectory> <topology> <dt> <max_lag>" << std::endl;
+        return 1;
+    }
+
+    int rank, size;
+    Parallel::initialize(rank, size);
+
+    chemfiles::Trajectory trajectory(argv[1]);
+    trajectory.set_topology(argv[2], "LAMMPS Data");
+    double dt = std::atof(argv[3]);
+    size_t max_lag = std::strtoul(argv[4], nullptr, 10);
+
+    size_t n_frames = trajectory.nsteps();
+    auto topology = trajectory.read_step(0).topology();
+
+    CollectiveMSD collective(topology, n_frames);
+
+    // Each rank reduces its own frame range to collective vectors
+    size_t start_frame, end_frame;
+    Parallel::distribute_frames(rank, size, n_frames, start_frame, end_frame);
+    for (size_t i = start_frame; i < end_frame; ++i) {
+        collective.add_frame(i, trajectory.read_step(i));
+    }
+
+    collective.allreduce(MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        auto pairs = collective.compute(max_lag);
+        auto total = collective.total(pairs);
+
+        std::cout << "# t total";
+        for (size_t a = 0; a < collective.n_species(); ++a) {
+            for (size_t b = a; b < collective.n_species(); ++b) {
+                std::cout << " " << collective.species_name(a) << "-" << collective.species_name(b);
+            }
+        }
+        std::cout << "\n";
+
+        for (size_t k = 0; k < total.size(); ++k) {
+            std::cout << k * dt << " " << total[k];
+            for (const auto& msd : pairs) std::cout << " " << msd[k];
+            std::cout << "\n";
+        }
+    }
+
+    Parallel::finalize();
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <chemfiles.hpp>
+#include "group_msd.hpp"
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <trajectory> <topology> <max_lag> <species|molecules|index.ndx> [remove_drift=1]" << std::endl;
+        return 1;
+    }
+
+    chemfiles::Trajectory trajectory(argv[1]);
+    trajectory.set_topology(argv[2], "LAMMPS Data");
+    size_t max_lag = std::strtoul(argv[3], nullptr, 10);
+    std::string grouping = argv[4];
+    bool remove_drift = argc > 5 ? std::atoi(argv[5]) != 0 : true;
+
+    size_t n_frames = trajectory.nsteps();
+    auto topology = trajectory.read_step(0).topology();
+
+    Groups groups;
+    if (grouping == "species") {
+        groups = species_groups(topology);
+    } else if (grouping == "molecules") {
+        groups = molecule_groups(topology);
+    } else {
+        groups = read_index_groups(grouping, topology.size());
+    }
+
+    // Single pass over the trajectory, accumulating straight into group means
+    GroupMSD msd(groups, topology, max_lag, remove_drift);
+    for (size_t i = 0; i < n_frames; ++i) {
+        msd.add_frame(trajectory.read_step(i));
+    }
+
+    auto result = msd.compute();
+    std::cout << "# lag";
+    for (const auto& name : msd.group_names()) std::cout << " " << name;
+    std::cout << "\n";
+    for (size_t tau = 0; tau <= max_lag; ++tau) {
+        std::cout << tau;
+        for (const auto& group : result) std::cout << " " << group[tau];
+        std::cout << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <omp.h>
+#include "msd.hpp"
+
+// Function to initialize positions using a random walk
+std::vector<std::vector<std::vector<float>>> initialize_random_walk(size_t n_frames, size_t n_particles, float step_size = 1.0f) {
+    std::vector<std::vector<std::vector<float>>> positions(n_frames, std::vector<std::vector<float>>(n_particles, std::vector<float>(3, 0.0f)));
+    
+    // Random number generator for the random walk
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<float> dis(-step_size, step_size);
+
+    // Initialize each particle's position at frame 0
+    for (size_t p = 0; p < n_particles; ++p) {
+        for (size_t d = 0; d < 3; ++d) {
+            positions[0][p][d] = 0.0f; // Start at origin
+        }
+    }
+
+    // Perform random walk for each particle over all frames
+    for (size_t f = 1; f < n_frames; ++f) {
+        for (size_t p = 0; p < n_particles; ++p) {
+            for (size_t d = 0; d < 3; ++d) {
+                // Each step is a random displacement in [-step_size, step_size]
+                positions[f][p][d] = positions[f-1][p][d] + dis(gen);
+            }
+        }
+    }
+
+    return positions;
+}
+
+int main() {
+    size_t n_frames = 100;      // Number of frames (time steps)
+    size_t n_particles = 1000;  // Number of particles
+    float step_size = 1.0f;     // Step size for the random walk
+
+    // Initialize positions using random walk
+    std::vector<std::vector<std::vector<float>>> positions = initialize_random_walk(n_frames, n_particles, step_size);
+
+    // Set the number of threads for OpenMP
+    omp_set_num_threads(4);
+
+    // Compute MSD using AVX and OpenMP for multiple time lags
+    std::vector<std::vector<float>> msd = compute_MSD_AVX_OpenMP(positions);
+
+    // Output results for a few lags
+    std::cout << "Mean Squared Displacement (MSD) for each particle at different time lags:" << std::endl;
+    for (size_t tau = 1; tau < 10; ++tau) {
+        std::cout << "Lag " << tau << ": ";
+        for (size_t p = 0; p < 5; ++p) { // Display first 5 particles for simplicity
+            std::cout << msd[tau][p] << " ";
+        }
+        std::cout << std::endl;
+    }
+
+    // Particle-averaged MSD with error bars from 10 independent time blocks
+    MSDBlockResult blocks = compute_MSD_blocks(positions, 10, 10);
+
+    std::cout << "Block-averaged MSD (mean, block standard error, blocking error, plateau level):" << std::endl;
+    for (size_t tau = 1; tau < blocks.mean.size(); ++tau) {
+        std::cout << "Lag " << tau << ": " << blocks.mean[tau] << " "
+                  << blocks.std_error[tau] << " " << blocks.blocking_error[tau] << " "
+                  << blocks.blocking_level[tau] << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chemfiles.hpp>
+#include "vacf.hpp"
+
+// Print a Green-Kubo table: time, ACF, running integral and its error
+void print_green_kubo(const std::string& title, const GreenKuboResult& result, double dt) {
+    std::cout << "# " << title << "\n# t acf integral error\n";
+    for (size_t k = 0; k < result.acf.size(); ++k) {
+        std::cout << k * dt << " " << result.acf[k] << " "
+                  << result.integral[k] << " " << result.error[k] << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <trajectory> <dt> <block_length> <max_lag> [<prefactor> <property>...]" << std::endl;
+        return 1;
+    }
+
+    std::string trajectory_file = argv[1];
+    double dt = std::atof(argv[2]);
+    size_t block_length = std::strtoul(argv[3], nullptr, 10);
+    size_t max_lag = std::strtoul(argv[4], nullptr, 10);
+
+    // Optional stress or heat-flux components, e.g. "pxy pxz pyz" with V/kT
+    double prefactor = argc > 5 ? std::atof(argv[5]) : 1.0;
+    std::vector<std::string> properties(argv + std::min(argc, 6), argv + argc);
+
+    chemfiles::Trajectory trajectory(trajectory_file);
+    size_t n_frames = trajectory.nsteps();
+    if (n_frames == 0) {
+        std::cerr << "Error: " << trajectory_file << " has no frames" << std::endl;
+        return 1;
+    }
+    auto frame = trajectory.read_step(0);
+
+    VACF vacf(frame.size(), block_length, max_lag);
+    std::vector<PropertyACF> property_acf;
+    if (!properties.empty()) {
+        property_acf.emplace_back(properties, block_length, max_lag);
+    }
+
+    // Single pass: each frame feeds every correlation engine
+    for (size_t i = 0; i < n_frames; ++i) {
+        if (i > 0) frame = trajectory.read_step(i);  // frame 0 is already decoded
+        vacf.add_frame(frame);
+        for (auto& acf : property_acf) acf.add_frame(frame);
+    }
+
+    std::cout << "# " << n_frames << " frames, " << vacf.acf().n_blocks()
+              << " blocks of " << block_length << " frames" << std::endl;
+
+    print_green_kubo("VACF / diffusion coefficient", green_kubo(vacf.acf().block_acfs(), dt, 1.0), dt);
+    for (auto& acf : property_acf) {
+        print_green_kubo("Property ACF / transport coefficient", green_kubo(acf.acf().block_acfs(), dt, prefactor), dt);
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <chemfiles.hpp>
+#include "van_hove.hpp"
+#include "../mpi/src/utils/parallel.hpp"
+
+int main(int argc, char** argv) {
+    if (argc < 6) {
+        std::cerr << "Usage: " << argv[0] << " <trajectory> <max_lag> <n_lags> <r_max> <n_bins>" << std::endl;
+        return 1;
+    }
+
+    int rank, size;
+    Parallel::initialize(rank, size);
+
+    chemfiles::Trajectory trajectory(argv[1]);
+    size_t max_lag = std::strtoul(argv[2], nullptr, 10);
+    size_t n_lags = std::strtoul(argv[3], nullptr, 10);
+    double r_max = std::atof(argv[4]);
+    size_t n_bins = std::strtoul(argv[5], nullptr, 10);
+
+    size_t n_frames = trajectory.nsteps();
+    VanHove van_hove(log_lags(std::min(max_lag, n_frames - 1), n_lags), r_max, n_bins);
+
+    // Each rank owns a range of time origins and loads the frames they reach
+    size_t start_frame, end_frame;
+    Parallel::distribute_frames(rank, size, n_frames, start_frame, end_frame);
+    size_t last_frame = std::min(end_frame + van_hove.lag_values().back(), n_frames);
+
+    Positions positions;
+    for (size_t i = start_frame; i < last_frame; ++i) {
+        auto frame = trajectory.read_step(i);
+        auto r = frame.positions();
+        std::vector<std::vector<float>> coordinates(frame.size(), std::vector<float>(3));
+        for (size_t p = 0; p < frame.size(); ++p) {
+            coordinates[p] = {static_cast<float>(r[p][0]), static_cast<float>(r[p][1]), static_cast<float>(r[p][2])};
+        }
+        positions.push_back(std::move(coordinates));
+    }
+
+    if (!positions.empty()) {
+        van_hove.accumulate(positions, 0, end_frame - start_frame);
+    }
+    van_hove.reduce(MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        auto g = van_hove.normalized();
+        std::cout << "# r";
+        for (size_t lag : van_hove.lag_values()) std::cout << " Gs(r," << lag << ")";
+        std::cout << "\n";
+
+        for (size_t b = 0; b < n_bins; ++b) {
+            std::cout << (b + 0.5) * van_hove.bin_width();
+            for (const auto& gs : g) std::cout << " " << gs[b];
+            std::cout << "\n";
+        }
+    }
+
+    Parallel::finalize();
+    return 0;
+}
@@ -1,12 +1,14 @@
-#include <iostream>
+#include "msd.hpp"
+#include "correlation.hpp"
 #include <immintrin.h>
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 #include <cmath>
-#include <random>
 #include <omp.h>
 
 // Function to compute MSD using AVX and OpenMP for multiple time lags
-std::vector<std::vector<float>> compute_MSD_AVX_OpenMP(const std::vector<std::vector<std::vector<float>>>& positions) {
+std::vector<std::vector<float>> compute_MSD_AVX_OpenMP(const Positions& positions) {
     size_t n_frames = positions.size();
     size_t n_particles = positions[0].size();
     size_t dim = 3; // x, y, z
@@ -86,58 +88,92 @@ std::vector<std::vector<float>> compute_MSD_AVX_OpenMP(const std::vector<std::ve
     return msd;
 }
 
-// Function to initialize positions using a random walk
-std::vector<std::vector<std::vector<float>>> initialize_random_walk(size_t n_frames, size_t n_particles, float step_size = 1.0f) {
-    std::vector<std::vector<std::vector<float>>> positions(n_frames, std::vector<std::vector<float>>(n_particles, std::vector<float>(3, 0.0f)));
-    
-    // Random number generator for the random walk
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(-step_size, step_size);
+MSDBlockResult compute_MSD_blocks(const Positions& positions, size_t n_blocks, size_t max_lag) {
+    size_t n_frames = positions.size();
+    size_t n_particles = positions[0].size();
+
+    if (n_blocks == 0 || n_frames / n_blocks < 2) {
+        throw std::runtime_error("compute_MSD_blocks needs at least 2 frames per block");
+    }
 
-    // Initialize each particle's position at frame 0
+    size_t block_length = n_frames / n_blocks;
+    size_t n_lags = std::min(max_lag, block_length);
+
+    // Trajectories in SoA, particle by particle, shared by every thread
+    std::vector<float> x(n_particles * n_frames), y(n_particles * n_frames), z(n_particles * n_frames);
+    #pragma omp parallel for schedule(static)
     for (size_t p = 0; p < n_particles; ++p) {
-        for (size_t d = 0; d < 3; ++d) {
-            positions[0][p][d] = 0.0f; // Start at origin
+        for (size_t t = 0; t < n_frames; ++t) {
+            x[p * n_frames + t] = positions[t][p][0];
+            y[p * n_frames + t] = positions[t][p][1];
+            z[p * n_frames + t] = positions[t][p][2];
         }
     }
 
-    // Perform random walk for each particle over all frames
-    for (size_t f = 1; f < n_frames; ++f) {
-        for (size_t p = 0; p < n_particles; ++p) {
-            for (size_t d = 0; d < 3; ++d) {
-                // Each step is a random displacement in [-step_size, step_size]
-                positions[f][p][d] = positions[f-1][p][d] + dis(gen);
+    // Squared displacement summed over particles for every lag and time
+    // origin, series[tau][t] with t = b * block_length + origin within the
+    // block. Each (lag, block) pair owns its slice, so threads write their
+    // pairs in place; work shrinks with the lag, hence the dynamic schedule
+    std::vector<double> total(n_lags * n_blocks * block_length, 0.0);
+    #pragma omp parallel for collapse(2) schedule(dynamic)
+    for (size_t tau = 1; tau < n_lags; ++tau) {
+        for (size_t b = 0; b < n_blocks; ++b) {
+            size_t n_origins = block_length - tau;
+            double* series = &total[(tau * n_blocks + b) * block_length];
+
+            for (size_t p = 0; p < n_particles; ++p) {
+                const float* bx = &x[p * n_frames + b * block_length];
+                const float* by = &y[p * n_frames + b * block_length];
+                const float* bz = &z[p * n_frames + b * block_length];
+
+                #pragma omp simd
+                for (size_t t = 0; t < n_origins; ++t) {
+                    float dx = bx[t + tau] - bx[t];
+                    float dy = by[t + tau] - by[t];
+                    float dz = bz[t + tau] - bz[t];
+                    series[t] += dx * dx + dy * dy + dz * dz;
+                }
             }
         }
     }
 
-    return positions;
-}
-
-int main() {
-    size_t n_frames = 100;      // Number of frames (time steps)
-    size_t n_particles = 1000;  // Number of particles
-    float step_size = 1.0f;     // Step size for the random walk
-
-    // Initialize positions using random walk
-    std::vector<std::vector<std::vector<float>>> positions = initialize_random_walk(n_frames, n_particles, step_size);
-
-    // Set the number of threads for OpenMP
-    omp_set_num_threads(4);
-
-    // Compute MSD using AVX and OpenMP for multiple time lags
-    std::vector<std::vector<float>> msd = compute_MSD_AVX_OpenMP(positions);
+    MSDBlockResult result;
+    result.blocks.assign(n_blocks, std::vector<double>(n_lags, 0.0));
+    result.mean.assign(n_lags, 0.0);
+    result.std_error.assign(n_lags, 0.0);
+    result.blocking_error.assign(n_lags, 0.0);
+    result.blocking_level.assign(n_lags, 0);
+
+    for (size_t tau = 1; tau < n_lags; ++tau) {
+        size_t n_origins = block_length - tau;
+        for (size_t b = 0; b < n_blocks; ++b) {
+            const double* series = &total[(tau * n_blocks + b) * block_length];
+            double sum = 0.0;
+            for (size_t t = 0; t < n_origins; ++t) sum += series[t];
+            result.blocks[b][tau] = sum / (static_cast<double>(n_origins) * n_particles);
+        }
+    }
 
-    // Output results for a few lags
-    std::cout << "Mean Squared Displacement (MSD) for each particle at different time lags:" << std::endl;
-    for (size_t tau = 1; tau < 10; ++tau) {
-        std::cout << "Lag " << tau << ": ";
-        for (size_t p = 0; p < 5; ++p) { // Display first 5 particles for simplicity
-            std::cout << msd[tau][p] << " ";
+    // Reduce the block estimates lag by lag; the blocking analysis runs on
+    // the per-origin series, whose mean is the same as the mean over blocks
+    std::vector<double> values(n_blocks), series;
+    for (size_t tau = 1; tau < n_lags; ++tau) {
+        for (size_t b = 0; b < n_blocks; ++b) values[b] = result.blocks[b][tau];
+
+        BlockEstimate estimate = block_estimate(values);
+        result.mean[tau] = estimate.mean;
+        result.std_error[tau] = estimate.std_error;
+
+        size_t n_origins = block_length - tau;
+        series.clear();
+        for (size_t b = 0; b < n_blocks; ++b) {
+            const double* origins = &total[(tau * n_blocks + b) * block_length];
+            for (size_t t = 0; t < n_origins; ++t) series.push_back(origins[t] / n_particles);
         }
-        std::cout << std::endl;
+        std::vector<BlockingLevel> levels = flyvbjerg_petersen(series);
+        result.blocking_level[tau] = blocking_plateau_level(levels);
+        result.blocking_error[tau] = blocking_plateau(levels);
     }
 
-    return 0;
-}
\ No newline at end of file
+    return result;
+}
@@ -0,0 +1,29 @@
+#ifndef MSD_HPP
+#define MSD_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Positions indexed as positions[frame][particle][dim]
+using Positions = std::vector<std::vector<std::vector<float>>>;
+
+// Function to compute MSD using AVX and OpenMP for multiple time lags
+std::vector<std::vector<float>> compute_MSD_AVX_OpenMP(const Positions& positions);
+
+// MSD estimated independently on K contiguous time blocks
+struct MSDBlockResult {
+    std::vector<std::vector<double>> blocks;    // K x max_lag particle-averaged MSD
+    std::vector<double> mean;                   // mean over blocks, per lag
+    std::vector<double> std_error;              // standard error over blocks, per lag
+    std::vector<double> blocking_error;         // Flyvbjerg-Petersen plateau, per lag
+    std::vector<size_t> blocking_level;         // blocking level of the plateau (blocks of 2^level origins)
+};
+
+// Particle-averaged MSD over n_blocks time blocks in a single pass, threads
+// sharing out the (lag, block) pairs and filling their series in place. The
+// blocking error comes from the series of particle-averaged squared
+// displacements per time origin (origins of every block, in time order),
+// whose correlation the block standard error cannot see within a block
+MSDBlockResult compute_MSD_blocks(const Positions& positions, size_t n_blocks, size_t max_lag);
+
+#endif // MSD_HPP
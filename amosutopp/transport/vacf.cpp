@@ -0,0 +1,37 @@
+#include "vacf.hpp"
+#include <stdexcept>
+
+VACF::VACF(size_t n_atoms, size_t block_length, size_t max_lag)
+    : n_atoms(n_atoms), engine(3 * n_atoms, block_length, max_lag) {}
+
+void VACF::add_frame(const chemfiles::Frame& frame) {
+    auto velocities = frame.velocities();
+    if (!velocities) {
+        throw std::runtime_error("Frame " + std::to_string(frame.step()) + " has no velocities");
+    }
+    if (frame.size() != n_atoms) {
+        throw std::runtime_error("Number of atoms changed along the trajectory");
+    }
+
+    const auto& v = *velocities;
+    for (size_t i = 0; i < n_atoms; ++i) {
+        engine.value(3 * i + 0) = static_cast<float>(v[i][0]);
+        engine.value(3 * i + 1) = static_cast<float>(v[i][1]);
+        engine.value(3 * i + 2) = static_cast<float>(v[i][2]);
+    }
+    engine.end_frame();
+}
+
+PropertyACF::PropertyACF(const std::vector<std::string>& names, size_t block_length, size_t max_lag)
+    : names(names), engine(names.size(), block_length, max_lag) {}
+
+void PropertyACF::add_frame(const chemfiles::Frame& frame) {
+    for (size_t s = 0; s < names.size(); ++s) {
+        auto property = frame.get(names[s]);
+        if (!property) {
+            throw std::runtime_error("Frame " + std::to_string(frame.step()) + " has no property '" + names[s] + "'");
+        }
+        engine.value(s) = static_cast<float>(property->as_double());
+    }
+    engine.end_frame();
+}
@@ -0,0 +1,42 @@
+#ifndef VACF_HPP
+#define VACF_HPP
+
+#include "green_kubo.hpp"
+#include <chemfiles.hpp>
+#include <string>
+#include <vector>
+
+// Velocity autocorrelation <v_a(0) v_a(t)>, averaged over atoms and the
+// three Cartesian components. D = int_0^inf VACF dt.
+class VACF {
+public:
+    VACF(size_t n_atoms, size_t block_length, size_t max_lag);
+
+    // Push the velocities of one frame (throws if the frame has none)
+    void add_frame(const chemfiles::Frame& frame);
+
+    const BlockACF& acf() const { return engine; }
+
+private:
+    size_t n_atoms;
+    BlockACF engine;
+};
+
+// Autocorrelation of scalar frame properties, e.g. the off-diagonal stress
+// components (pxy, pxz, pyz) for the viscosity or the heat flux (jx, jy, jz)
+// for the thermal conductivity. Components are averaged together.
+class PropertyACF {
+public:
+    PropertyACF(const std::vector<std::string>& names, size_t block_length, size_t max_lag);
+
+    // Push the named properties of one frame (throws if one is missing)
+    void add_frame(const chemfiles::Frame& frame);
+
+    const BlockACF& acf() const { return engine; }
+
+private:
+    std::vector<std::string> names;
+    BlockACF engine;
+};
+
+#endif // VACF_HPP
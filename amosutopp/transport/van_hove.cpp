@@ -0,0 +1,118 @@
+#include "van_hove.hpp"
+#include "../devel/analysis/histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <omp.h>
+
+std::vector<size_t> log_lags(size_t max_lag, size_t n_lags) {
+    std::vector<size_t> lags;
+    if (max_lag == 0 || n_lags == 0) return lags;
+
+    double ratio = n_lags > 1 ? std::log(static_cast<double>(max_lag)) / (n_lags - 1) : 0.0;
+    for (size_t i = 0; i < n_lags; ++i) {
+        size_t lag = static_cast<size_t>(std::lround(std::exp(ratio * i)));
+        lag = std::min(std::max<size_t>(lag, 1), max_lag);
+        if (lags.empty() || lag != lags.back()) lags.push_back(lag);
+    }
+    return lags;
+}
+
+VanHove::VanHove(const std::vector<size_t>& lags, double r_max, size_t n_bins)
+    : lags(lags), r_max(r_max), n_bins(n_bins),
+      counts(lags.size() * n_bins, 0.0), samples(lags.size(), 0.0) {
+    if (lags.empty() || n_bins == 0 || r_max <= 0.0) {
+        throw std::runtime_error("VanHove needs at least one lag, one bin and r_max > 0");
+    }
+}
+
+void VanHove::accumulate(const Positions& positions, size_t origin_begin, size_t origin_end) {
+    size_t n_frames = positions.size();
+    size_t n_particles = positions[0].size();
+    size_t n_lags = lags.size();
+    origin_end = std::min(origin_end, n_frames);
+
+    const float inv_width = static_cast<float>(n_bins / r_max);
+    const int overflow = static_cast<int>(n_bins);
+    const size_t stride = n_bins + 1;
+    constexpr size_t chunk = 256;
+
+    // Thread-private bins with one overflow bin per lag
+    Histogram histogram(n_lags * stride);
+
+    #pragma omp parallel
+    {
+        double* local = histogram.thread_bins(omp_get_thread_num());
+        std::vector<double> local_samples(n_lags, 0.0);
+
+        alignas(64) float dx[chunk], dy[chunk], dz[chunk];
+        alignas(64) int bin[chunk];
+
+        #pragma omp for collapse(2) schedule(dynamic)
+        for (size_t l = 0; l < n_lags; ++l) {
+            for (size_t t = origin_begin; t < origin_end; ++t) {
+                size_t tau = lags[l];
+                if (t + tau >= n_frames) continue;
+
+                const auto& r0 = positions[t];
+                const auto& r1 = positions[t + tau];
+                const int first = static_cast<int>(l * stride);
+
+                for (size_t p0 = 0; p0 < n_particles; p0 += chunk) {
+                    size_t m = std::min(chunk, n_particles - p0);
+
+                    for (size_t k = 0; k < m; ++k) {
+                        dx[k] = r1[p0 + k][0] - r0[p0 + k][0];
+                        dy[k] = r1[p0 + k][1] - r0[p0 + k][1];
+                        dz[k] = r1[p0 + k][2] - r0[p0 + k][2];
+                    }
+
+                    // Vectorised distance and bin index, out-of-range goes to the overflow bin
+                    #pragma omp simd aligned(dx, dy, dz, bin : 64)
+                    for (size_t k = 0; k < m; ++k) {
+                        float r = std::sqrt(dx[k] * dx[k] + dy[k] * dy[k] + dz[k] * dz[k]);
+                        int b = static_cast<int>(r * inv_width);
+                        bin[k] = first + (b < overflow ? b : overflow);
+                    }
+
+                    Histogram::add_batch(local, bin, m);
+                }
+                local_samples[l] += n_particles;
+            }
+        }
+
+        #pragma omp critical
+        for (size_t l = 0; l < n_lags; ++l) samples[l] += local_samples[l];
+    }
+
+    histogram.merge();
+    for (size_t l = 0; l < n_lags; ++l) {
+        for (size_t b = 0; b < n_bins; ++b) counts[l * n_bins + b] += histogram.bins()[l * stride + b];
+    }
+}
+
+void VanHove::reduce(MPI_Comm comm, int root) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    void* send_counts = (rank == root) ? MPI_IN_PLACE : counts.data();
+    void* send_samples = (rank == root) ? MPI_IN_PLACE : samples.data();
+    MPI_Reduce(send_counts, counts.data(), static_cast<int>(counts.size()), MPI_DOUBLE, MPI_SUM, root, comm);
+    MPI_Reduce(send_samples, samples.data(), static_cast<int>(samples.size()), MPI_DOUBLE, MPI_SUM, root, comm);
+}
+
+std::vector<std::vector<double>> VanHove::normalized() const {
+    double width = bin_width();
+    std::vector<std::vector<double>> g(lags.size(), std::vector<double>(n_bins, 0.0));
+
+    for (size_t l = 0; l < lags.size(); ++l) {
+        if (samples[l] == 0.0) continue;
+        for (size_t b = 0; b < n_bins; ++b) {
+            double r_lo = b * width;
+            double r_hi = r_lo + width;
+            double shell = 4.0 / 3.0 * M_PI * (r_hi * r_hi * r_hi - r_lo * r_lo * r_lo);
+            g[l][b] = counts[l * n_bins + b] / (samples[l] * shell);
+        }
+    }
+    return g;
+}
@@ -0,0 +1,39 @@
+#ifndef VAN_HOVE_HPP
+#define VAN_HOVE_HPP
+
+#include "msd.hpp"
+#include <mpi.h>
+#include <cstddef>
+#include <vector>
+
+// Up to n_lags distinct lags spaced logarithmically in [1, max_lag]
+std::vector<size_t> log_lags(size_t max_lag, size_t n_lags);
+
+// Self van Hove function G_s(r, t) at a set of lags: histograms of the
+// single-particle displacement |r_i(t0 + t) - r_i(t0)| over all particles
+// and time origins
+class VanHove {
+public:
+    VanHove(const std::vector<size_t>& lags, double r_max, size_t n_bins);
+
+    // Histogram the displacements of origins [origin_begin, origin_end)
+    void accumulate(const Positions& positions, size_t origin_begin, size_t origin_end);
+
+    // Sum the histograms of every rank of `comm` onto `root`
+    void reduce(MPI_Comm comm, int root = 0);
+
+    // G_s(r, t) per lag, normalised so that int 4 pi r^2 G_s dr = 1
+    std::vector<std::vector<double>> normalized() const;
+
+    const std::vector<size_t>& lag_values() const { return lags; }
+    double bin_width() const { return r_max / n_bins; }
+
+private:
+    std::vector<size_t> lags;
+    double r_max;
+    size_t n_bins;
+    std::vector<double> counts;     // n_lags x n_bins
+    std::vector<double> samples;    // displacements drawn per lag (in and out of range)
+};
+
+#endif // VAN_HOVE_HPP
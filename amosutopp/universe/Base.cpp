@@ -10,8 +10,18 @@ void Base::add_common_args(CLI::App* app) {
         ->required();
     app->add_option("-p,--topology", topology_file, "Path to the topology file")
         ->required();
+    app->add_option("--begin", begin_frame, "First frame to analyse");
+    app->add_option("--end", end_frame, "Frame to stop before (default: the last frame)");
+    app->add_option("--stride", stride, "Analyse every n-th frame")
+        ->check(CLI::PositiveNumber);
+    app->add_option("--select", selection, "Atoms to read, e.g. \"0-99,250\" (default: all)");
+    app->add_option("--frame-cache", frame_cache_mb, "Memory for recently used frames, in MiB (default: 0, off)");
+    app->add_option("--prefetch", prefetch_depth, "Frames read ahead into the frame cache (default: 0)");
 }
 
 void Base::init_universe() {
     universe = new Universe(trajectory_file, topology_file);
+    universe->set_frame_range({begin_frame, end_frame, stride});
+    universe->set_selection(selection);
+    universe->set_frame_cache(frame_cache_mb << 20, prefetch_depth);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define BASE_HPP
 
 #include "universe.hpp"
+#include <limits>
 #include <string>
 #include <CLI/CLI.hpp>
 
@@ -11,13 +12,23 @@ public:
     std::string trajectory_file;
     std::string topology_file;
 
+    // Frames and atoms to read
+    size_t begin_frame = 0;
+    size_t end_frame = std::numeric_limits<size_t>::max();
+    size_t stride = 1;
+    std::string selection = "all";
+
+    // Decoded frames kept in memory, and read ahead into them
+    size_t frame_cache_mb = 0;
+    size_t prefetch_depth = 0;
+
     // Universe object shared across all analyses
     Universe* universe;
 
     // Virtual destructor for proper cleanup
     virtual ~Base();
 
-    // Add common arguments (trajectory, topology) to any subcommand
+    // Add common arguments (trajectory, topology, frame range, selection) to any subcommand
     virtual void add_common_args(CLI::App* app);
 
     // Initialize the Universe with trajectory and topology
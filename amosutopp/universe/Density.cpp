@@ -10,8 +10,8 @@ Density::~Density() {
 }
 
 void Density::run() {
-    // Perform the density analysis by iterating over all frames
-    for (size_t i = 0; i < universe->n_frames_total(); ++i) {
+    // Perform the density analysis by iterating over the frames in the range
+    for (size_t i : universe->frame_indices()) {
         universe->set_frame_number(i);
         std::cout << "\nFrame " << i << ":\n";
         universe->print_info();
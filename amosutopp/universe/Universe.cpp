@@ -1,23 +1,19 @@
 #include "universe.hpp"
+#include <algorithm>
 #include <iostream>
 
 // Constructor: loads the trajectory and topology
 Universe::Universe(const std::string& trajectory_file, const std::string& topology_file)
-    : trajectory(trajectory_file), current_frame_index(0) {
-    // Set the topology
-    trajectory.set_topology(topology_file, "LAMMPS Data");
-
+    : trajectory_file(trajectory_file),
+      trajectory(trajectory_file, topology_file),
+      current_frame_index(0) {
     // Get the number of frames in the trajectory
-    n_frames = trajectory.nsteps();
-
-    // Read the topology once (for atom data)
-    topology = trajectory.read().topology();
+    n_frames = trajectory.get_n_frames();
+    frames = FrameRange().frames(n_frames);
 
     // Store the masses of atoms
-    masses.clear();
-    for (size_t i = 0; i < topology.size() / 10000; ++i) {
-        masses.push_back(topology[i].mass());
-    }
+    auto cached_masses = trajectory.topology_arrays().masses();
+    masses.assign(cached_masses.begin(), cached_masses.begin() + n_atoms() / 10000);
 }
 
 // Access the total number of frames
@@ -35,14 +31,80 @@ void Universe::set_frame_number(size_t frame_index) {
     current_frame_index = frame_index;
 }
 
+// Restrict the analysis to a range of frames
+void Universe::set_frame_range(const FrameRange& range) {
+    frames = range.frames(n_frames);
+    this->range = range;
+    stop_prefetch();
+}
+
+// Frames in the range
+const std::vector<size_t>& Universe::frame_indices() const {
+    return frames;
+}
+
 // Get the current frame
-chemfiles::Frame Universe::current_frame() {
-    return trajectory.read_step(current_frame_index);
+const chemfiles::Frame& Universe::current_frame() {
+    size_t i = current_frame_index;
+    if (cache.lookup(i, buffer)) return buffer.frame;
+
+    // Frames the prefetcher has read up to this one go to the cache
+    while (prefetcher) {
+        const FrameBuffer* next = prefetcher->acquire();
+        if (!next || next->index > i) break;
+        size_t index = next->index;
+        cache.insert(*next);
+        prefetcher->release();
+        if (index == i) break;
+    }
+    if (cache.lookup(i, buffer)) return buffer.frame;
+
+    // Not read ahead (a jump, or no prefetching): read it here, then read
+    // ahead again from the next frame of the range
+    stop_prefetch();
+    trajectory.read_into(i, buffer);
+    cache.insert(buffer);
+    if (prefetch_depth > 0 && cache.size() > 0) {  // frames read ahead only help if they can be kept
+        prefetcher = std::make_unique<FramePrefetcher>(trajectory, i + range.stride, std::min(range.end, n_frames),
+                                                       prefetch_depth, range.stride);
+    }
+    return buffer.frame;
+}
+
+// Cache decoded frames, optionally read ahead
+void Universe::set_frame_cache(size_t budget_bytes, size_t prefetch_depth) {
+    stop_prefetch();
+    cache.set_budget(budget_bytes);
+    this->prefetch_depth = prefetch_depth;
+}
+
+// Hand the trajectory handler back to this thread
+void Universe::stop_prefetch() {
+    prefetcher.reset();
+}
+
+// Select the atoms whose positions are read
+void Universe::set_selection(const std::string& spec) {
+    selection = parse_atom_selection(spec, n_atoms());
+}
+
+// Positions of the selected atoms in the current frame
+const std::vector<float>& Universe::selected_positions() {
+    stop_prefetch();
+    trajectory.read_positions(current_frame_index, selection, positions);
+    return positions;
+}
+
+// Load every frame in the range into memory
+const TrajectoryTensor& Universe::load_all(const std::string& selection, TrajectoryTensor::DType dtype) {
+    auto atoms = parse_atom_selection(selection, n_atoms());
+    tensor = load_trajectory(trajectory_file, trajectory.topology_arrays(), frames, atoms, dtype);
+    return tensor;
 }
 
 // Get the number of atoms in the current frame
 size_t Universe::n_atoms() const {
-    return topology.size();  // Number of atoms in the topology
+    return trajectory.topology_arrays().n_atoms();  // Number of atoms in the topology
 }
 
 // Get the atom masses in the current frame
@@ -2,7 +2,14 @@
 #define UNIVERSE_HPP
 
 #include <chemfiles.hpp>
+#include <memory>
+#include <string>
 #include <vector>
+#include "../devel/frame_cache.hpp"
+#include "../devel/frame_prefetcher.hpp"
+#include "../devel/frame_selection.hpp"
+#include "../devel/trajectory_handler.hpp"
+#include "../devel/trajectory_tensor.hpp"
 
 class Universe {
 public:
@@ -18,8 +25,35 @@ public:
     // Set the current frame number
     void set_frame_number(size_t frame_index);
 
-    // Get the current frame
-    chemfiles::Frame current_frame();
+    // Restrict the analysis to a range of frames with a stride
+    void set_frame_range(const FrameRange& range);
+
+    // Indices of the frames in the range, in order
+    const std::vector<size_t>& frame_indices() const;
+
+    // Get the current frame, read into storage reused from frame to frame;
+    // valid until the next call
+    const chemfiles::Frame& current_frame();
+
+    // Keep up to budget_bytes of decoded frames for current_frame(), least
+    // recently used evicted first, so revisited frames are not decoded again.
+    // With prefetch_depth > 0, the frames of the range after the one last
+    // read are decoded ahead on a background thread into the cache
+    void set_frame_cache(size_t budget_bytes, size_t prefetch_depth = 0);
+
+    // Restrict the positions read to a subset of atoms ("all", or indices and
+    // ranges such as "0-99,250")
+    void set_selection(const std::string& spec);
+
+    // Positions of the selected atoms in the current frame, x, y, z per atom;
+    // only the selected atoms are read or parsed
+    const std::vector<float>& selected_positions();
+
+    // Load the positions of every frame in the range for the selected atoms
+    // into memory, decoded in parallel by several readers; analyses then
+    // work on tensor.view<float>() (or <double>) as (frame, atom, xyz)
+    const TrajectoryTensor& load_all(const std::string& selection = "all",
+                                     TrajectoryTensor::DType dtype = TrajectoryTensor::DType::Float32);
 
     // Get the number of atoms in the current frame
     size_t n_atoms() const;
@@ -31,10 +65,21 @@ public:
     void print_info() const;
 
 private:
-    chemfiles::Trajectory trajectory;   // Trajectory file handler
-    chemfiles::Topology topology;       // Topology data
+    void stop_prefetch();
+
+    std::string trajectory_file;        // Path, for the readers of load_all
+    TrajectoryHandler trajectory;       // Trajectory file handler, with the cached topology
     size_t n_frames;                    // Number of frames in the trajectory
     size_t current_frame_index;         // Current frame index
+    FrameRange range;                   // Range of frames to analyse
+    std::vector<size_t> frames;         // Frames in the range
+    std::vector<size_t> selection;      // Selected atoms, empty for all
+    std::vector<float> positions;       // Positions of the selected atoms
+    FrameBuffer buffer;                 // Storage of the current frame
+    FrameCache cache;                   // Recently used frames
+    size_t prefetch_depth = 0;          // Frames decoded ahead into the cache
+    std::unique_ptr<FramePrefetcher> prefetcher;  // Owns the trajectory handler while alive
+    TrajectoryTensor tensor;            // Frames loaded by load_all
 
     // Atom information
     std::vector<double> masses;         // Masses of atoms in the current frame
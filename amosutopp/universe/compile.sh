@@ -1 +1 @@
-g++-14 main.cpp Universe.cpp Density.cpp Base.cpp -o main -I/usr/local/include -lchemfiles -L/usr/local/lib
\ No newline at end of file
+g++-14 -std=c++20 -fopenmp -pthread main.cpp Universe.cpp Density.cpp Base.cpp ../devel/trajectory_handler.cpp ../devel/dcd_reader.cpp ../devel/frame_index.cpp ../devel/topology_cache.cpp ../devel/frame_selection.cpp ../devel/text_frame_parser.cpp ../devel/trajectory_tensor.cpp ../devel/frame_cache.cpp ../devel/frame_prefetcher.cpp -o main -I/usr/local/include -lchemfiles -L/usr/local/lib
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/array.h>
+#include <nanobind/ndarray.h>
+#include <omp.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nb = nanobind;
+
+using Positions = nb::ndarray<const double, nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+
+// Pairs found by one thread, i < j, in the order the cells were swept
+struct PairChunk {
+    std::vector<int64_t> i, j;
+    std::vector<double> d;
+};
+
+// Periodic cell grid, cells at least `cutoff` wide, counting-sorted in parallel
+struct CellGrid {
+    int n[3];
+    std::vector<size_t> start;      // particles of cell c are order[start[c] .. start[c + 1])
+    std::vector<int64_t> order;
+    std::vector<double> sorted;     // xyz in cell order, so neighbour cells are read contiguously
+    std::vector<int> cell_of;
+    std::vector<size_t> adjacency_start;  // neighbour cells of c are adjacency[adjacency_start[c] ..)
+    std::vector<int> adjacency;
+
+    CellGrid(const double* x, size_t n_particles, const std::array<double, 3>& box, double cutoff) {
+        for (int d = 0; d < 3; ++d) n[d] = std::max(1, static_cast<int>(box[d] / cutoff));
+        size_t n_cells = static_cast<size_t>(n[0]) * n[1] * n[2];
+        cell_of.resize(n_particles);
+
+        int n_threads = omp_get_max_threads();
+        std::vector<size_t> counts(static_cast<size_t>(n_threads) * n_cells, 0);
+        start.assign(n_cells + 1, 0);
+        order.resize(n_particles);
+
+        #pragma omp parallel num_threads(n_threads)
+        {
+            int t = omp_get_thread_num();
+            size_t* local = counts.data() + static_cast<size_t>(t) * n_cells;
+
+            #pragma omp for schedule(static)
+            for (size_t p = 0; p < n_particles; ++p) {
+                int c[3];
+                for (int d = 0; d < 3; ++d) {
+                    double s = x[3 * p + d] / box[d];
+                    s -= std::floor(s);
+                    c[d] = std::min(static_cast<int>(s * n[d]), n[d] - 1);
+                }
+                cell_of[p] = (c[0] * n[1] + c[1]) * n[2] + c[2];
+                local[cell_of[p]]++;
+            }
+
+            // Exclusive offsets per (cell, thread), so the scatter is stable
+            #pragma omp single
+            {
+                size_t offset = 0;
+                for (size_t c = 0; c < n_cells; ++c) {
+                    start[c] = offset;
+                    for (int u = 0; u < n_threads; ++u) {
+                        size_t count = counts[static_cast<size_t>(u) * n_cells + c];
+                        counts[static_cast<size_t>(u) * n_cells + c] = offset;
+                        offset += count;
+                    }
+                }
+                start[n_cells] = offset;
+            }
+
+            #pragma omp for schedule(static)
+            for (size_t p = 0; p < n_particles; ++p) order[local[cell_of[p]]++] = static_cast<int64_t>(p);
+
+            #pragma omp single
+            sorted.resize(3 * n_particles);
+
+            #pragma omp for schedule(static)
+            for (size_t k = 0; k < n_particles; ++k) {
+                for (int d = 0; d < 3; ++d) sorted[3 * k + d] = x[3 * order[k] + d];
+            }
+        }
+
+        adjacency_start.assign(n_cells + 1, 0);
+        std::vector<int> cells;
+        for (size_t c = 0; c < n_cells; ++c) {
+            neighbours(static_cast<int>(c), cells);
+            adjacency.insert(adjacency.end(), cells.begin(), cells.end());
+            adjacency_start[c + 1] = adjacency.size();
+        }
+    }
+
+    // Unique periodic neighbours of `cell`, itself included (small grids
+    // would otherwise repeat some of the 27)
+    void neighbours(int cell, std::vector<int>& out) const {
+        int cx = cell / (n[1] * n[2]), cy = (cell / n[2]) % n[1], cz = cell % n[2];
+        out.clear();
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dz = -1; dz <= 1; ++dz) {
+                    int nx = (cx + dx + n[0]) % n[0];
+                    int ny = (cy + dy + n[1]) % n[1];
+                    int nz = (cz + dz + n[2]) % n[2];
+                    out.push_back((nx * n[1] + ny) * n[2] + nz);
+                }
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+};
+
+// All pairs closer than cutoff (minimum image in an orthorhombic box), each
+// once as (i < j, d). Threads sweep whole cells, reading the positions in
+// cell order, and emit into their own chunk.
+static std::vector<PairChunk> find_pairs(const double* x, size_t n_particles,
+                                         const std::array<double, 3>& box, double cutoff) {
+    if (cutoff <= 0.0 || cutoff > 0.5 * std::min({box[0], box[1], box[2]})) {
+        throw std::invalid_argument("cutoff must be positive and at most half the box length");
+    }
+
+    CellGrid grid(x, n_particles, box, cutoff);
+    const std::vector<double>& sorted = grid.sorted;
+    double cutoff2 = cutoff * cutoff;
+    double inv_box[3] = {1.0 / box[0], 1.0 / box[1], 1.0 / box[2]};
+    size_t n_cells = grid.start.size() - 1;
+    std::vector<PairChunk> chunks(omp_get_max_threads());
+
+    #pragma omp parallel num_threads(static_cast<int>(chunks.size()))
+    {
+        PairChunk& chunk = chunks[omp_get_thread_num()];
+
+        #pragma omp for schedule(dynamic, 16)
+        for (size_t cell = 0; cell < n_cells; ++cell) {
+            for (size_t a = grid.start[cell]; a < grid.start[cell + 1]; ++a) {
+                for (size_t n = grid.adjacency_start[cell]; n < grid.adjacency_start[cell + 1]; ++n) {
+                    int other = grid.adjacency[n];
+                    for (size_t b = std::max(grid.start[other], a + 1); b < grid.start[other + 1]; ++b) {
+                        double r2 = 0.0;
+                        for (int d = 0; d < 3; ++d) {
+                            double dx = sorted[3 * a + d] - sorted[3 * b + d];
+                            dx -= box[d] * std::rint(dx * inv_box[d]);
+                            r2 += dx * dx;
+                        }
+                        if (r2 < cutoff2) {
+                            int64_t p = grid.order[a], q = grid.order[b];
+                            chunk.i.push_back(std::min(p, q));
+                            chunk.j.push_back(std::max(p, q));
+                            chunk.d.push_back(std::sqrt(r2));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return chunks;
+}
+
+// Parallel merge of the per-thread chunks into (i, j)-sorted arrays: a
+// counting sort on i (rows of pairs, like a CSR matrix), then every row
+// sorted on j
+static void merge_pairs(const std::vector<PairChunk>& chunks, size_t n_particles,
+                        int64_t* i, int64_t* j, double* d) {
+    std::vector<size_t> row_start(n_particles + 1, 0);
+
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t t = 0; t < chunks.size(); ++t) {
+        for (int64_t p : chunks[t].i) {
+            #pragma omp atomic
+            row_start[p + 1]++;
+        }
+    }
+    for (size_t p = 0; p < n_particles; ++p) row_start[p + 1] += row_start[p];
+
+    std::vector<size_t> fill(row_start.begin(), row_start.end() - 1);
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t t = 0; t < chunks.size(); ++t) {
+        const PairChunk& chunk = chunks[t];
+        for (size_t k = 0; k < chunk.i.size(); ++k) {
+            size_t slot;
+            #pragma omp atomic capture
+            slot = fill[chunk.i[k]]++;
+            j[slot] = chunk.j[k];
+            d[slot] = chunk.d[k];
+        }
+    }
+
+    #pragma omp parallel
+    {
+        std::vector<std::pair<int64_t, double>> row;
+
+        #pragma omp for schedule(dynamic, 1024)
+        for (size_t p = 0; p < n_particles; ++p) {
+            size_t begin = row_start[p], end = row_start[p + 1];
+            row.clear();
+            for (size_t k = begin; k < end; ++k) row.emplace_back(j[k], d[k]);
+            std::sort(row.begin(), row.end());
+            for (size_t k = begin; k < end; ++k) {
+                i[k] = static_cast<int64_t>(p);
+                j[k] = row[k - begin].first;
+                d[k] = row[k - begin].second;
+            }
+        }
+    }
+}
+
+// Numpy array that owns `data` (freed with delete[] when the array dies)
+template <class T>
+static nb::ndarray<nb::numpy, T, nb::shape<-1>> owning_array(T* data, size_t size) {
+    nb::capsule owner(data, [](void* p) noexcept { delete[] static_cast<T*>(p); });
+    return nb::ndarray<nb::numpy, T, nb::shape<-1>>(data, {size}, owner);
+}
+
+nb::tuple cutoff_pairs(const Positions& positions, const std::array<double, 3>& box, double cutoff) {
+    size_t n_particles = positions.shape(0);
+    const double* x = positions.data();
+
+    int64_t* i = nullptr;
+    int64_t* j = nullptr;
+    double* d = nullptr;
+    size_t total = 0;
+    {
+        nb::gil_scoped_release release;
+        std::vector<PairChunk> chunks = find_pairs(x, n_particles, box, cutoff);
+        for (const PairChunk& chunk : chunks) total += chunk.i.size();
+
+        i = new int64_t[std::max<size_t>(total, 1)];
+        j = new int64_t[std::max<size_t>(total, 1)];
+        d = new double[std::max<size_t>(total, 1)];
+        merge_pairs(chunks, n_particles, i, j, d);
+    }
+
+    return nb::make_tuple(owning_array(i, total), owning_array(j, total), owning_array(d, total));
+}
+
+NB_MODULE(cutoff_pairs_module, m) {
+    m.def("cutoff_pairs", &cutoff_pairs,
+          "All pairs i < j closer than cutoff in a periodic orthorhombic box, sorted by (i, j).\n"
+          "Returns (i, j, d) numpy arrays that own the C++ buffers.",
+          nb::arg("positions"), nb::arg("box"), nb::arg("cutoff"));
+}
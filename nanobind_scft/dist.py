@@ -1,5 +1,9 @@
 import numpy as np
 from scipy.spatial import cKDTree
+try:
+    import cutoff_pairs_module
+except ImportError:  # extension not built: compute_distances_native falls back to cKDTree
+    cutoff_pairs_module = None
 
 def sort_pairs(pairs):
     """
@@ -146,6 +150,30 @@ def compute_distances_kdtree_periodic(positions, box_size, cutoff):
     return sort_pairs(pairs)  # Sort the pairs before returning
 
 
+def compute_distances_native(positions, box_size, cutoff):
+    """
+    Compute distances between particles within the cutoff with the C++ cell grid.
+    
+    Parameters:
+        positions (np.ndarray): Array of positions of shape (N, 3).
+        box_size (float): Size of the cubic simulation box.
+        cutoff (float): Cutoff distance for neighbor search.
+        
+    Returns:
+        i, j, d (np.ndarray): Pairs i < j and their distances, already sorted by (i, j).
+        The arrays own the C++ buffers, nothing is copied. Without the extension,
+        the same pairs come from cKDTree.
+    """
+    positions = np.ascontiguousarray(positions, dtype=np.float64)
+    if cutoff_pairs_module is None:
+        tree = cKDTree(np.mod(positions, box_size), boxsize=box_size)
+        pairs = tree.query_pairs(cutoff, output_type='ndarray')
+        pairs = pairs[np.lexsort((pairs[:, 1], pairs[:, 0]))]
+        delta = positions[pairs[:, 0]] - positions[pairs[:, 1]]
+        delta -= np.round(delta / box_size) * box_size
+        return pairs[:, 0], pairs[:, 1], np.sqrt(np.sum(delta ** 2, axis=1))
+    return cutoff_pairs_module.cutoff_pairs(positions, (box_size, box_size, box_size), cutoff)
+
 
 import time
 
@@ -175,6 +203,17 @@ pairs_cell_list = compute_distances(positions, cells, cell_indices, cell_size, n
 cell_list_time = time.time() - start_time
 print(f"Cell Lists Method: {len(pairs_cell_list)} pairs found in {cell_list_time:.4f} seconds")
 
+# Native C++ Method
+start_time = time.time()
+pairs_i, pairs_j, pairs_d = compute_distances_native(positions, box_size, cutoff)
+native_time = time.time() - start_time
+native_name = "Native C++" if cutoff_pairs_module is not None else "cKDTree (extension not built)"
+print(f"{native_name} Method: {len(pairs_d)} pairs found in {native_time:.4f} seconds")
+
+assert len(pairs_d) == len(pairs_brute_force), "Mismatch found!"
+assert all(bf[0] == i and bf[1] == j for bf, i, j in zip(pairs_brute_force, pairs_i, pairs_j)), "Mismatch found!"
+assert np.allclose([bf[2] for bf in pairs_brute_force], pairs_d), "Mismatch found!"
+
 # Compare Results
 # print("\nComparison of Results:")
 # for bf, kd, cl in zip(pairs_brute_force, pairs_kdtree_periodic, pairs_cell_list):
@@ -186,4 +225,4 @@ for bf, cl in zip(pairs_brute_force, pairs_cell_list):
     print(f"Pair {bf[0]}, {bf[1]} -> Distance: {bf[2]:.4f}")
 
 
-https://stackoverflow.com/questions/21285058/find-all-point-pairs-closer-than-a-given-maximum-distance
\ No newline at end of file
+# https://stackoverflow.com/questions/21285058/find-all-point-pairs-closer-than-a-given-maximum-distance
@@ -1,15 +1,22 @@
 #define _POSIX_C_SOURCE 199309L
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include "pdists.h"
 
-extern void pairwise_distances(int n_particles, float* positions, float* distances, float* exec_time);
+static double seconds_since(const struct timespec* start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        printf("Usage: %s <number_of_particles>\n", argv[0]);
+    if (argc != 2 && argc != 3 && argc != 6) {
+        printf("Usage: %s <number_of_particles> [dense|condensed|quantized|file|histogram|cutoff|nearest] [Lx Ly Lz]\n", argv[0]);
         return 1;
     }
+    const char* mode = argc > 2 ? argv[2] : "dense";
 
     int n_particles = atoi(argv[1]);
     if (n_particles <= 0) {
@@ -18,13 +25,21 @@ int main(int argc, char* argv[]) {
     }
 
     float* positions = (float*)malloc(n_particles * 3 * sizeof(float));
-    float* distances = (float*)malloc(n_particles * n_particles * sizeof(float));
     float exec_time;
 
+    // Orthorhombic cell, unit cube by default (row-major, cell vectors as columns)
+    float box[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    if (argc == 6) {
+        box[0] = atof(argv[3]);
+        box[4] = atof(argv[4]);
+        box[8] = atof(argv[5]);
+    }
+    float half_box = 0.5f * (box[0] < box[4] ? (box[0] < box[8] ? box[0] : box[8]) : (box[4] < box[8] ? box[4] : box[8]));
+
     // Initialize positions (example: random initialization)
     srand(time(NULL));
     for (int i = 0; i < n_particles * 3; i++) {
-        positions[i] = (double)rand() / RAND_MAX;
+        positions[i] = box[(i % 3) * 4] * (double)rand() / RAND_MAX;
     }
 
     // Debugging: Print positions array
@@ -33,15 +48,75 @@ int main(int argc, char* argv[]) {
     //     printf("positions(%d, :) = [%f, %f, %f]\n", i, positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
     // }
 
-    // Call the pairwise_distances function
-    pairwise_distances(n_particles, positions, distances, &exec_time);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (strcmp(mode, "dense") == 0) {
+        // Full n x n matrix
+        float* distances = (float*)malloc((size_t)n_particles * n_particles * sizeof(float));
+        pairwise_distances(n_particles, positions, box, distances, &exec_time);
+        free(distances);
+    } else if (strcmp(mode, "condensed") == 0) {
+        // Upper triangle only, half the memory
+        float* distances = (float*)malloc(pdists_condensed_size(n_particles) * sizeof(float));
+        pairwise_condensed(n_particles, positions, box, distances);
+        exec_time = seconds_since(&start);
+        free(distances);
+    } else if (strcmp(mode, "quantized") == 0) {
+        // Upper triangle in 16-bit fixed point over [0, half the box diagonal]
+        float r_max = half_box * 1.7320508f;
+        uint16_t* distances = (uint16_t*)malloc(pdists_condensed_size(n_particles) * sizeof(uint16_t));
+        pairwise_condensed_u16(n_particles, positions, box, 0.0f, r_max, distances);
+        exec_time = seconds_since(&start);
+        free(distances);
+    } else if (strcmp(mode, "file") == 0) {
+        // Condensed float32 streamed into pdists.bin in 256 MB row blocks
+        if (pairwise_condensed_file("pdists.bin", n_particles, positions, box, 0, 0.0f, 0.0f, (size_t)1 << 28) != 0) {
+            perror("pdists.bin");
+            return 1;
+        }
+        exec_time = seconds_since(&start);
+    } else if (strcmp(mode, "histogram") == 0) {
+        // Streamed into 100 bins up to half the box, O(N) memory
+        double counts[100];
+        pdists_histogram h;
+        pdists_histogram_init(&h, 100, half_box);
+        pairwise_visit(n_particles, positions, box, pdists_histogram_visit, &h);
+        pdists_histogram_finish(&h, counts);
+        exec_time = seconds_since(&start);
+        printf("Pairs in first bin: %.0f\n", counts[0]);
+    } else if (strcmp(mode, "cutoff") == 0) {
+        pdists_cutoff c;
+        pdists_pair_list pairs;
+        pdists_cutoff_init(&c, 0.1f * half_box);
+        pairwise_visit(n_particles, positions, box, pdists_cutoff_visit, &c);
+        pdists_cutoff_finish(&c, &pairs);
+        exec_time = seconds_since(&start);
+        printf("Pairs within cutoff: %zu\n", pairs.size);
+        free(pairs.i);
+        free(pairs.j);
+        free(pairs.r);
+    } else if (strcmp(mode, "nearest") == 0) {
+        float* min_r = (float*)malloc(n_particles * sizeof(float));
+        int* min_j = (int*)malloc(n_particles * sizeof(int));
+        pdists_nearest m;
+        pdists_nearest_init(&m, n_particles);
+        pairwise_visit(n_particles, positions, box, pdists_nearest_visit, &m);
+        pdists_nearest_finish(&m, min_r, min_j);
+        exec_time = seconds_since(&start);
+        printf("Nearest neighbour of particle 0: %d at %f\n", min_j[0], min_r[0]);
+        free(min_r);
+        free(min_j);
+    } else {
+        printf("Unknown mode %s\n", mode);
+        return 1;
+    }
 
     // Print the execution time
     printf("Execution time (seconds): %f\n", exec_time);
 
     // Free allocated memory
     free(positions);
-    free(distances);
 
     return 0;
 }
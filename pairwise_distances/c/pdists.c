@@ -1,49 +1,258 @@
+#define _POSIX_C_SOURCE 200809L
+#include "pdists.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <float.h>
+#include <stdint.h>
+#include <immintrin.h>
 #include <math.h>
 #include <omp.h>
 #include <time.h>
 
 
-void pairwise_distances(int n_particles, float* positions, float* distances, float* exec_time) {
-    int i, j;
-    float L = 1.0;
-    float half_L = 0.5;
-    float dx, dy, dz, dist;
+// Vector width abstraction: AVX-512, AVX2 or scalar, picked at compile time
+#if defined(__AVX512F__)
+typedef __m512 vfloat;
+#define VLEN 16
+#define vset1(x) _mm512_set1_ps(x)
+#define vload(p) _mm512_load_ps(p)
+#define vstore(p, v) _mm512_store_ps(p, v)
+#define vsub(a, b) _mm512_sub_ps(a, b)
+#define vmul(a, b) _mm512_mul_ps(a, b)
+#define vfmadd(a, b, c) _mm512_fmadd_ps(a, b, c)
+#define vfnmadd(a, b, c) _mm512_fnmadd_ps(a, b, c)
+#define vround(x) _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define vsqrt(x) _mm512_sqrt_ps(x)
+#elif defined(__AVX2__) && defined(__FMA__)
+typedef __m256 vfloat;
+#define VLEN 8
+#define vset1(x) _mm256_set1_ps(x)
+#define vload(p) _mm256_load_ps(p)
+#define vstore(p, v) _mm256_store_ps(p, v)
+#define vsub(a, b) _mm256_sub_ps(a, b)
+#define vmul(a, b) _mm256_mul_ps(a, b)
+#define vfmadd(a, b, c) _mm256_fmadd_ps(a, b, c)
+#define vfnmadd(a, b, c) _mm256_fnmadd_ps(a, b, c)
+#define vround(x) _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define vsqrt(x) _mm256_sqrt_ps(x)
+#else
+typedef float vfloat;
+#define VLEN 1
+#define vset1(x) (x)
+#define vload(p) (*(p))
+#define vstore(p, v) (*(p) = (v))
+#define vsub(a, b) ((a) - (b))
+#define vmul(a, b) ((a) * (b))
+#define vfmadd(a, b, c) ((a) * (b) + (c))
+#define vfnmadd(a, b, c) ((c) - (a) * (b))
+#define vround(x) rintf(x)
+#define vsqrt(x) sqrtf(x)
+#endif
 
-    // Initialize distances to zero
-    for (i = 0; i < n_particles * n_particles; i++) {
-        distances[i] = 0.0;
+// Cell matrix and inverse diagonal broadcast once per tile
+typedef struct {
+    vfloat h[9];
+    vfloat inv_diag[3];
+} vbox;
+
+// Branchless minimum image, nearest lattice translation subtracted
+static inline void minimum_image_orthorhombic(const vbox* box, vfloat* dx, vfloat* dy, vfloat* dz) {
+    *dx = vfnmadd(box->h[0], vround(vmul(*dx, box->inv_diag[0])), *dx);
+    *dy = vfnmadd(box->h[4], vround(vmul(*dy, box->inv_diag[1])), *dy);
+    *dz = vfnmadd(box->h[8], vround(vmul(*dz, box->inv_diag[2])), *dz);
+}
+
+// Reduce along c, then b, then a: the true minimum image for separations
+// below half the smallest face width in the usual restricted triclinic cells
+static inline void minimum_image_triclinic(const vbox* box, vfloat* dx, vfloat* dy, vfloat* dz) {
+    vfloat s = vround(vmul(*dz, box->inv_diag[2]));
+    *dx = vfnmadd(box->h[2], s, *dx);
+    *dy = vfnmadd(box->h[5], s, *dy);
+    *dz = vfnmadd(box->h[8], s, *dz);
+
+    s = vround(vmul(*dy, box->inv_diag[1]));
+    *dx = vfnmadd(box->h[1], s, *dx);
+    *dy = vfnmadd(box->h[4], s, *dy);
+
+    s = vround(vmul(*dx, box->inv_diag[0]));
+    *dx = vfnmadd(box->h[0], s, *dx);
+}
+
+// Positions as SoA, zero-padded to whole tiles and 64-byte aligned so the
+// inner loop only does aligned full-width loads
+typedef struct {
+    float* x;
+    float* y;
+    float* z;
+} soa_positions;
+
+// One tile kernel per cell shape, so the shape is never tested per pair.
+// Every row is computed over the full (padded) tile width.
+#define TILE_KERNEL(name, minimum_image)                                                                   \
+static void name(const soa_positions* r, const vbox* box, int i0, int ni, int j0, float* tile) {           \
+    for (int a = 0; a < ni; a++) {                                                                         \
+        vfloat xi = vset1(r->x[i0 + a]);                                                                   \
+        vfloat yi = vset1(r->y[i0 + a]);                                                                   \
+        vfloat zi = vset1(r->z[i0 + a]);                                                                   \
+        float* row = tile + a * PDISTS_TILE;                                                               \
+                                                                                                           \
+        for (int b = 0; b < PDISTS_TILE; b += VLEN) {                                                      \
+            vfloat dx = vsub(xi, vload(r->x + j0 + b));                                                    \
+            vfloat dy = vsub(yi, vload(r->y + j0 + b));                                                    \
+            vfloat dz = vsub(zi, vload(r->z + j0 + b));                                                    \
+            minimum_image(box, &dx, &dy, &dz);                                                             \
+            vfloat r2 = vfmadd(dz, dz, vfmadd(dy, dy, vmul(dx, dx)));                                      \
+            vstore(row + b, vsqrt(r2));                                                                    \
+        }                                                                                                  \
+    }                                                                                                      \
+}
+
+TILE_KERNEL(tile_orthorhombic, minimum_image_orthorhombic)
+TILE_KERNEL(tile_triclinic, minimum_image_triclinic)
+
+typedef void (*tile_kernel)(const soa_positions*, const vbox*, int, int, int, float*);
+
+// Interleaved bits of (ti, tj): visiting the triangle of tiles in this
+// Z-order keeps recently used rows and columns of positions in cache at
+// every level without knowing the cache sizes
+static uint64_t morton_key(uint32_t ti, uint32_t tj) {
+    uint64_t key = 0;
+    for (int bit = 0; bit < 32; bit++) {
+        key |= (uint64_t)((ti >> bit) & 1u) << (2 * bit + 1);
+        key |= (uint64_t)((tj >> bit) & 1u) << (2 * bit);
     }
+    return key;
+}
 
-    struct timespec start, end;
+static int compare_keys(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a, kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
 
-    // Start time
-    clock_gettime(CLOCK_MONOTONIC, &start);
+// Shared by the float and double entry points: exactly one of positions_f32
+// and positions_f64 is set, and is read only once, into the SoA copy
+static void visit_rows(int n_particles, const float* positions_f32, const double* positions_f64, const float* box,
+                       int row_begin, int row_end, pdists_visitor visit, void* ctx) {
+    int triclinic = (box[1] != 0.0f || box[2] != 0.0f || box[5] != 0.0f);
+    vbox vb;
+    for (int k = 0; k < 9; k++) vb.h[k] = vset1(box[k]);
+    vb.inv_diag[0] = vset1(1.0f / box[0]);
+    vb.inv_diag[1] = vset1(1.0f / box[4]);
+    vb.inv_diag[2] = vset1(1.0f / box[8]);
+
+    // Cell shape dispatched once per call
+    tile_kernel kernel = triclinic ? tile_triclinic : tile_orthorhombic;
+    int n_tiles = (n_particles + PDISTS_TILE - 1) / PDISTS_TILE;
+    int first_tile = row_begin / PDISTS_TILE;
+    int last_tile = (row_end + PDISTS_TILE - 1) / PDISTS_TILE;
+    if (last_tile <= first_tile) return;
+
+    size_t padded = (size_t)n_tiles * PDISTS_TILE;
+    soa_positions r;
+    r.x = (float*)aligned_alloc(64, 3 * padded * sizeof(float));
+    r.y = r.x + padded;
+    r.z = r.y + padded;
+    for (size_t i = 0; i < padded; i++) {
+        float xyz[3] = {0.0f, 0.0f, 0.0f};
+        if (i < (size_t)n_particles) {
+            for (int d = 0; d < 3; d++) xyz[d] = positions_f32 ? positions_f32[3 * i + d] : (float)positions_f64[3 * i + d];
+        }
+        r.x[i] = xyz[0];
+        r.y[i] = xyz[1];
+        r.z[i] = xyz[2];
+    }
+
+    // Upper triangle of tiles in the requested rows, sorted into Z-order
+    size_t n_pairs = 0;
+    for (int ti = first_tile; ti < last_tile; ti++) n_pairs += n_tiles - ti;
+    uint64_t* order = (uint64_t*)malloc(n_pairs * sizeof(uint64_t));
+    size_t p = 0;
+    for (int ti = first_tile; ti < last_tile; ti++) {
+        for (int tj = ti; tj < n_tiles; tj++) order[p++] = morton_key(ti, tj);
+    }
+    qsort(order, n_pairs, sizeof(uint64_t), compare_keys);
 
-    #pragma omp parallel for private(i, j, dx, dy, dz, dist) shared(n_particles, positions, distances) schedule(dynamic)
-    for (i = 0; i < n_particles; i++) {
-        for (j = i + 1; j < n_particles; j++) {
-            dx = positions[i * 3 + 0] - positions[j * 3 + 0];
-            dy = positions[i * 3 + 1] - positions[j * 3 + 1];
-            dz = positions[i * 3 + 2] - positions[j * 3 + 2];
+    // One task per tile, balanced across the triangle by the task scheduler
+    #pragma omp parallel
+    #pragma omp single
+    #pragma omp taskloop grainsize(4)
+    for (size_t q = 0; q < n_pairs; q++) {
+        float tile[PDISTS_TILE * PDISTS_TILE] __attribute__((aligned(64)));
+        int ti = 0, tj = 0;
+        for (int bit = 0; bit < 32; bit++) {
+            ti |= (int)((order[q] >> (2 * bit + 1)) & 1u) << bit;
+            tj |= (int)((order[q] >> (2 * bit)) & 1u) << bit;
+        }
 
-            // Apply periodic boundary conditions
-            if (dx > half_L) dx -= L;
-            if (dx < -half_L) dx += L;
-            if (dy > half_L) dy -= L;
-            if (dy < -half_L) dy += L;
-            if (dz > half_L) dz -= L;
-            if (dz < -half_L) dz += L;
+        int i0 = ti * PDISTS_TILE, j0 = tj * PDISTS_TILE;
+        int ni = n_particles - i0 < PDISTS_TILE ? n_particles - i0 : PDISTS_TILE;
+        int nj = n_particles - j0 < PDISTS_TILE ? n_particles - j0 : PDISTS_TILE;
+        kernel(&r, &vb, i0, ni, j0, tile);
 
-            dist = sqrt(dx * dx + dy * dy + dz * dz);
-            distances[i * n_particles + j] = dist;
-            distances[j * n_particles + i] = dist;
+        // Mask the lower triangle and the diagonal of diagonal tiles
+        if (ti == tj) {
+            for (int a = 0; a < ni; a++) {
+                for (int b = 0; b <= a; b++) tile[a * PDISTS_TILE + b] = FLT_MAX;
+            }
         }
+        visit(ctx, omp_get_thread_num(), i0, ni, j0, nj, tile);
     }
 
-    // End time
-    clock_t end_clock = clock();
+    free(order);
+    free(r.x);
+}
+
+void pairwise_visit(int n_particles, const float* positions, const float* box, pdists_visitor visit, void* ctx) {
+    visit_rows(n_particles, positions, NULL, box, 0, n_particles, visit, ctx);
+}
+
+void pairwise_visit_rows(int n_particles, const float* positions, const float* box, int row_begin, int row_end,
+                         pdists_visitor visit, void* ctx) {
+    visit_rows(n_particles, positions, NULL, box, row_begin, row_end, visit, ctx);
+}
+
+void pairwise_visit_f64(int n_particles, const double* positions, const float* box, pdists_visitor visit, void* ctx) {
+    visit_rows(n_particles, NULL, positions, box, 0, n_particles, visit, ctx);
+}
+
+// Writes the tile and its transpose as contiguous row segments instead of
+// scattering the symmetric entry of every pair
+void pdists_dense_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile) {
+    pdists_dense* m = (pdists_dense*)ctx;
+    size_t n = m->n_particles;
+    int diagonal = (i0 == j0);
+    (void)thread;
+
+    for (int a = 0; a < ni; a++) {
+        int b0 = diagonal ? a + 1 : 0;
+        memcpy(m->distances + (i0 + a) * n + j0 + b0, tile + a * PDISTS_TILE + b0, (nj - b0) * sizeof(float));
+    }
+    for (int b = 0; b < nj; b++) {
+        float* row = m->distances + (j0 + b) * n + i0;
+        int a1 = diagonal ? b : ni;
+        for (int a = 0; a < a1; a++) row[a] = tile[a * PDISTS_TILE + b];
+    }
+}
+
+void pairwise_distances(int n_particles, float* positions, const float* box, float* distances, float* exec_time) {
+    size_t i;
+    pdists_dense matrix = {n_particles, distances};
+
+    // Initialize distances to zero
+    for (i = 0; i < (size_t)n_particles * n_particles; i++) {
+        distances[i] = 0.0;
+    }
+
+    struct timespec start, end;
+
+    // Start time
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pairwise_visit(n_particles, positions, box, pdists_dense_visit, &matrix);
 
     // End time
     clock_gettime(CLOCK_MONOTONIC, &end);
@@ -58,3 +267,262 @@ void pairwise_distances(int n_particles, float* positions, float* distances, flo
     //     }
     // }
 }
+
+
+
+// Condensed upper triangle, row-major like scipy's pdist: (i, j > i) lives
+// at n * i - i * (i + 1) / 2 + j - i - 1
+size_t pdists_condensed_index(int n_particles, int i, int j) {
+    return (size_t)n_particles * i - (size_t)i * (i + 1) / 2 + (size_t)(j - i - 1);
+}
+
+size_t pdists_condensed_size(int n_particles) {
+    return (size_t)n_particles * (n_particles - 1) / 2;
+}
+
+// 16-bit fixed point over [r_min, r_max], resolution (r_max - r_min) / 65535
+static inline uint16_t quantize(float r, float r_min, float scale) {
+    float q = (r - r_min) * scale;
+    q = q < 0.0f ? 0.0f : (q > 65535.0f ? 65535.0f : q);
+    return (uint16_t)(q + 0.5f);
+}
+
+float pdists_dequantize(uint16_t q, float r_min, float r_max) {
+    return r_min + q * ((r_max - r_min) / 65535.0f);
+}
+
+void pdists_condensed_init(pdists_condensed* c, int n_particles, void* out, int quantized, float r_min, float r_max) {
+    c->n_particles = n_particles;
+    c->offset = 0;
+    c->out = out;
+    c->quantized = quantized;
+    c->r_min = r_min;
+    c->scale = quantized ? 65535.0f / (r_max - r_min) : 0.0f;
+}
+
+void pdists_condensed_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile) {
+    pdists_condensed* m = (pdists_condensed*)ctx;
+    (void)thread;
+    for (int a = 0; a < ni; a++) {
+        int i = i0 + a;
+        int b0 = j0 > i ? 0 : i - j0 + 1;  // pairs with j > i only
+        if (b0 >= nj) continue;
+
+        size_t k = pdists_condensed_index(m->n_particles, i, j0 + b0) - m->offset;
+        const float* row = tile + a * PDISTS_TILE;
+        if (m->quantized) {
+            uint16_t* out = (uint16_t*)m->out + k;
+            for (int b = b0; b < nj; b++) out[b - b0] = quantize(row[b], m->r_min, m->scale);
+        } else {
+            float* out = (float*)m->out + k;
+            for (int b = b0; b < nj; b++) out[b - b0] = row[b];
+        }
+    }
+}
+
+void pairwise_condensed(int n_particles, const float* positions, const float* box, float* distances) {
+    pdists_condensed m;
+    pdists_condensed_init(&m, n_particles, distances, 0, 0.0f, 0.0f);
+    pairwise_visit(n_particles, positions, box, pdists_condensed_visit, &m);
+}
+
+void pairwise_condensed_u16(int n_particles, const float* positions, const float* box,
+                            float r_min, float r_max, uint16_t* distances) {
+    pdists_condensed m;
+    pdists_condensed_init(&m, n_particles, distances, 1, r_min, r_max);
+    pairwise_visit(n_particles, positions, box, pdists_condensed_visit, &m);
+}
+
+int pairwise_condensed_file(const char* path, int n_particles, const float* positions, const float* box,
+                            int quantized, float r_min, float r_max, size_t block_bytes) {
+    size_t item = quantized ? sizeof(uint16_t) : sizeof(float);
+    size_t total = pdists_condensed_size(n_particles) * item;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    if (total > 0 && ftruncate(fd, (off_t)total) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // Whole tiles of rows per block, as many as fit the first (longest) rows into block_bytes
+    size_t row_bytes = (size_t)n_particles * item;
+    int block_rows = (int)(block_bytes / (row_bytes ? row_bytes : 1)) / PDISTS_TILE * PDISTS_TILE;
+    if (block_rows < PDISTS_TILE) block_rows = PDISTS_TILE;
+
+    pdists_condensed m;
+    pdists_condensed_init(&m, n_particles, NULL, quantized, r_min, r_max);
+
+    for (int row_begin = 0; row_begin < n_particles - 1; row_begin += block_rows) {
+        int row_end = row_begin + block_rows < n_particles ? row_begin + block_rows : n_particles;
+
+        // Condensed rows [row_begin, row_end) are one contiguous byte range, mapped page-aligned
+        size_t first = pdists_condensed_index(n_particles, row_begin, row_begin + 1) * item;
+        size_t last = (row_end < n_particles ? pdists_condensed_index(n_particles, row_end, row_end + 1) * item : total);
+        if (last == first) continue;
+        size_t map_begin = first / page * page;
+        size_t map_size = last - map_begin;
+
+        char* map = (char*)mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)map_begin);
+        if (map == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+
+        m.offset = first / item;
+        m.out = map + (first - map_begin);
+        pairwise_visit_rows(n_particles, positions, box, row_begin, row_end, pdists_condensed_visit, &m);
+
+        // Written back and dropped before the next block, so memory stays bounded
+        msync(map, map_size, MS_ASYNC);
+        munmap(map, map_size);
+    }
+
+    close(fd);
+    return 0;
+}
+
+void pdists_histogram_init(pdists_histogram* h, int n_bins, float r_max) {
+    h->n_bins = n_bins;
+    h->r_max = r_max;
+    h->n_threads = omp_get_max_threads();
+    h->bins = (double*)calloc((size_t)h->n_threads * n_bins, sizeof(double));
+}
+
+void pdists_histogram_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile) {
+    pdists_histogram* h = (pdists_histogram*)ctx;
+    double* bins = h->bins + (size_t)thread * h->n_bins;
+    float inv_width = h->n_bins / h->r_max;
+    (void)i0;
+    (void)j0;
+
+    for (int a = 0; a < ni; a++) {
+        for (int b = 0; b < nj; b++) {
+            float r = tile[a * PDISTS_TILE + b];
+            if (r < h->r_max) {
+                int bin = (int)(r * inv_width);
+                if (bin < h->n_bins) bins[bin] += 1.0;
+            }
+        }
+    }
+}
+
+void pdists_histogram_finish(pdists_histogram* h, double* counts) {
+    for (int b = 0; b < h->n_bins; b++) {
+        counts[b] = 0.0;
+        for (int t = 0; t < h->n_threads; t++) counts[b] += h->bins[(size_t)t * h->n_bins + b];
+    }
+    free(h->bins);
+    h->bins = NULL;
+}
+
+
+static void pair_list_push(pdists_pair_list* list, int i, int j, float r) {
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? 2 * list->capacity : 1024;
+        list->i = (int*)realloc(list->i, list->capacity * sizeof(int));
+        list->j = (int*)realloc(list->j, list->capacity * sizeof(int));
+        list->r = (float*)realloc(list->r, list->capacity * sizeof(float));
+    }
+    list->i[list->size] = i;
+    list->j[list->size] = j;
+    list->r[list->size] = r;
+    list->size++;
+}
+
+void pdists_cutoff_init(pdists_cutoff* c, float cutoff) {
+    c->cutoff = cutoff;
+    c->n_threads = omp_get_max_threads();
+    c->lists = (pdists_pair_list*)calloc(c->n_threads, sizeof(pdists_pair_list));
+}
+
+void pdists_cutoff_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile) {
+    pdists_cutoff* c = (pdists_cutoff*)ctx;
+    pdists_pair_list* list = &c->lists[thread];
+
+    for (int a = 0; a < ni; a++) {
+        for (int b = 0; b < nj; b++) {
+            float r = tile[a * PDISTS_TILE + b];
+            if (r < c->cutoff) pair_list_push(list, i0 + a, j0 + b, r);
+        }
+    }
+}
+
+void pdists_cutoff_finish(pdists_cutoff* c, pdists_pair_list* pairs) {
+    size_t total = 0;
+    for (int t = 0; t < c->n_threads; t++) total += c->lists[t].size;
+
+    pairs->size = pairs->capacity = total;
+    pairs->i = (int*)malloc((total ? total : 1) * sizeof(int));
+    pairs->j = (int*)malloc((total ? total : 1) * sizeof(int));
+    pairs->r = (float*)malloc((total ? total : 1) * sizeof(float));
+
+    size_t offset = 0;
+    for (int t = 0; t < c->n_threads; t++) {
+        pdists_pair_list* list = &c->lists[t];
+        if (list->size) {
+            memcpy(pairs->i + offset, list->i, list->size * sizeof(int));
+            memcpy(pairs->j + offset, list->j, list->size * sizeof(int));
+            memcpy(pairs->r + offset, list->r, list->size * sizeof(float));
+        }
+        offset += list->size;
+        free(list->i);
+        free(list->j);
+        free(list->r);
+    }
+    free(c->lists);
+    c->lists = NULL;
+}
+
+
+void pdists_nearest_init(pdists_nearest* m, int n_particles) {
+    size_t n = (size_t)omp_get_max_threads() * n_particles;
+    m->n_particles = n_particles;
+    m->n_threads = omp_get_max_threads();
+    m->min_r = (float*)malloc(n * sizeof(float));
+    m->min_j = (int*)malloc(n * sizeof(int));
+    for (size_t k = 0; k < n; k++) {
+        m->min_r[k] = FLT_MAX;
+        m->min_j[k] = -1;
+    }
+}
+
+void pdists_nearest_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile) {
+    pdists_nearest* m = (pdists_nearest*)ctx;
+    float* min_r = m->min_r + (size_t)thread * m->n_particles;
+    int* min_j = m->min_j + (size_t)thread * m->n_particles;
+
+    // Each pair updates both of its particles
+    for (int a = 0; a < ni; a++) {
+        for (int b = 0; b < nj; b++) {
+            float r = tile[a * PDISTS_TILE + b];
+            if (r < min_r[i0 + a]) {
+                min_r[i0 + a] = r;
+                min_j[i0 + a] = j0 + b;
+            }
+            if (r < min_r[j0 + b]) {
+                min_r[j0 + b] = r;
+                min_j[j0 + b] = i0 + a;
+            }
+        }
+    }
+}
+
+void pdists_nearest_finish(pdists_nearest* m, float* min_r, int* min_j) {
+    for (int i = 0; i < m->n_particles; i++) {
+        min_r[i] = FLT_MAX;
+        min_j[i] = -1;
+        for (int t = 0; t < m->n_threads; t++) {
+            size_t k = (size_t)t * m->n_particles + i;
+            if (m->min_r[k] < min_r[i]) {
+                min_r[i] = m->min_r[k];
+                min_j[i] = m->min_j[k];
+            }
+        }
+    }
+    free(m->min_r);
+    free(m->min_j);
+    m->min_r = NULL;
+    m->min_j = NULL;
+}
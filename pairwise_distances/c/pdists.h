@@ -0,0 +1,119 @@
+#ifndef PDISTS_H
+#define PDISTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The cell is a row-major 3x3 matrix with the cell vectors as columns,
+// upper triangular as in chemfiles: a = (ax, 0, 0), b = (bx, by, 0), c = (cx, cy, cz).
+// Orthorhombic cells only use the diagonal.
+
+// Dense n x n matrix, kept for small systems
+void pairwise_distances(int n_particles, float* positions, const float* box, float* distances, float* exec_time);
+
+// Streaming API: distances are computed per PDISTS_TILE x PDISTS_TILE tile
+// and handed to a visitor, so the n x n matrix never exists. The tile holds
+// the distances between particles [i0, i0 + ni) and [j0, j0 + nj), row
+// stride PDISTS_TILE. Every unordered pair is visited exactly once; on
+// diagonal tiles the entries with j <= i are FLT_MAX so visitors can treat
+// every entry alike. Called concurrently, `thread` is the OpenMP thread.
+#define PDISTS_TILE 64
+
+typedef void (*pdists_visitor)(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile);
+
+void pairwise_visit(int n_particles, const float* positions, const float* box, pdists_visitor visit, void* ctx);
+
+// Only the tiles of rows [row_begin, row_end), rounded out to whole tiles
+void pairwise_visit_rows(int n_particles, const float* positions, const float* box, int row_begin, int row_end,
+                         pdists_visitor visit, void* ctx);
+
+// Same from double positions, narrowed to float when they are copied into the
+// padded SoA buffer every call builds before tiling
+void pairwise_visit_f64(int n_particles, const double* positions, const float* box, pdists_visitor visit, void* ctx);
+
+// Full n x n matrix (both triangles, zero diagonal left to the caller)
+typedef struct {
+    int n_particles;
+    float* distances;
+} pdists_dense;
+
+void pdists_dense_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile);
+
+// Condensed upper triangle, n (n - 1) / 2 entries in scipy's pdist order:
+// pair (i, j > i) at pdists_condensed_index(n, i, j)
+size_t pdists_condensed_index(int n_particles, int i, int j);
+size_t pdists_condensed_size(int n_particles);
+
+void pairwise_condensed(int n_particles, const float* positions, const float* box, float* distances);
+
+// Condensed output as a visitor, float32 or quantised uint16 into `out`;
+// `offset` is the condensed index of out[0], so a row block can be written on its own
+typedef struct {
+    int n_particles;
+    size_t offset;
+    void* out;
+    int quantized;
+    float r_min;
+    float scale;
+} pdists_condensed;
+
+void pdists_condensed_init(pdists_condensed* c, int n_particles, void* out, int quantized, float r_min, float r_max);
+void pdists_condensed_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile);
+
+// Same, quantised to 16-bit fixed point over [r_min, r_max] (clamped),
+// resolution (r_max - r_min) / 65535
+void pairwise_condensed_u16(int n_particles, const float* positions, const float* box,
+                            float r_min, float r_max, uint16_t* distances);
+float pdists_dequantize(uint16_t q, float r_min, float r_max);
+
+// Condensed matrix (float32, or uint16 if `quantized`) written into a file
+// through mmap, a block of rows of about block_bytes at a time, so matrices
+// larger than RAM can be built and read back out of core (np.memmap).
+// Returns 0, or -1 with errno set.
+int pairwise_condensed_file(const char* path, int n_particles, const float* positions, const float* box,
+                            int quantized, float r_min, float r_max, size_t block_bytes);
+
+// Histogram of pair distances below r_max, thread-private bins
+typedef struct {
+    int n_bins;
+    float r_max;
+    int n_threads;
+    double* bins;           // n_threads * n_bins
+} pdists_histogram;
+
+void pdists_histogram_init(pdists_histogram* h, int n_bins, float r_max);
+void pdists_histogram_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile);
+void pdists_histogram_finish(pdists_histogram* h, double* counts);  // counts: n_bins, frees the bins
+
+// Every pair closer than cutoff, collected in thread-private growing lists
+typedef struct {
+    int* i;
+    int* j;
+    float* r;
+    size_t size;
+    size_t capacity;
+} pdists_pair_list;
+
+typedef struct {
+    float cutoff;
+    int n_threads;
+    pdists_pair_list* lists;  // one per thread
+} pdists_cutoff;
+
+void pdists_cutoff_init(pdists_cutoff* c, float cutoff);
+void pdists_cutoff_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile);
+void pdists_cutoff_finish(pdists_cutoff* c, pdists_pair_list* pairs);  // concatenated, caller frees the arrays
+
+// Nearest neighbour of every particle
+typedef struct {
+    int n_particles;
+    int n_threads;
+    float* min_r;           // n_threads * n_particles
+    int* min_j;
+} pdists_nearest;
+
+void pdists_nearest_init(pdists_nearest* m, int n_particles);
+void pdists_nearest_visit(void* ctx, int thread, int i0, int ni, int j0, int nj, const float* tile);
+void pdists_nearest_finish(pdists_nearest* m, float* min_r, int* min_j);  // n_particles each
+
+#endif // PDISTS_H
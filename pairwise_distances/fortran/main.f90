@@ -8,6 +8,7 @@ program main
 
     real(sp), allocatable :: positions(:,:)
     real(sp), allocatable :: distances(:,:)
+    real(sp) :: box(3, 3)
 
     ! Get the number of particles from the command line
     call get_command_argument(1, arg)
@@ -21,8 +22,14 @@ program main
     call random_seed(seed)
     call random_number(positions)
 
+    ! Unit cubic cell, cell vectors as columns
+    box = 0.0_sp
+    box(1, 1) = 1.0_sp
+    box(2, 2) = 1.0_sp
+    box(3, 3) = 1.0_sp
+
     ! Call the subroutine to compute pairwise distances
-    call pairwise_distances(positions, n_particles, distances)
+    call pairwise_distances(positions, n_particles, box, distances)
 
     ! Deallocate memory
     deallocate(positions)
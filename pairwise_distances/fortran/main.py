@@ -4,7 +4,8 @@ from pairwise_module import pairwise
 # Example usage
 n_particles = 40000
 positions = np.random.rand(n_particles, 3).astype(np.float32)
+box = np.eye(3, dtype=np.float32, order="F")  # cell vectors as columns
 
-pairwise.pairwise_distances(positions, n_particles)
+pairwise.pairwise_distances(positions, box, n_particles)
 
 # print("Execution time (seconds):", exec_time[0])
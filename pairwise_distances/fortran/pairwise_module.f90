@@ -5,19 +5,20 @@ module pairwise
     
 contains
 
-    subroutine pairwise_distances(positions, n_particles, distances)
+    ! box(:, k) is the k-th cell vector, upper triangular as in chemfiles:
+    ! a = (ax, 0, 0), b = (bx, by, 0), c = (cx, cy, cz). Orthorhombic cells
+    ! only use the diagonal.
+    subroutine pairwise_distances(positions, n_particles, box, distances)
         use omp_lib
         implicit none
         
         integer, intent(in) :: n_particles
         real(sp), intent(in) :: positions(n_particles, 3)
+        real(sp), intent(in) :: box(3, 3)
         real(sp), intent(out) :: distances(n_particles, n_particles)
-        integer :: i, j
         integer :: start_clock, end_clock, clock_rate
-        real(sp) :: L, half_L, dx, dy, dz, dist, exec_time
+        real(sp) :: exec_time
 
-        L = 1.0_sp
-        half_L = 0.5_sp
         distances = 0.0_sp
 
         ! Get the clock rate
@@ -29,6 +30,47 @@ contains
         !     print *, 'positions(', k, ',:) = ', positions(k, :)
         ! end do
 
+        ! Cell shape dispatched once per call, never per pair
+        if (box(1, 2) /= 0.0_sp .or. box(1, 3) /= 0.0_sp .or. box(2, 3) /= 0.0_sp) then
+            call pairwise_triclinic(positions, n_particles, box, distances)
+        else
+            call pairwise_orthorhombic(positions, n_particles, box, distances)
+        end if
+
+        ! Get the end time
+        call system_clock(end_clock)
+  
+        ! Calculate the execution time
+        exec_time = real(end_clock - start_clock) / real(clock_rate)
+        print *, 'Execution time (seconds):', exec_time
+
+        ! Debugging: Print the distances matrix
+        ! do i = 1, n_particles
+        !     do j = 1, n_particles
+        !         print *, 'distances(', i, ',', j, ') = ', distances(i, j)
+        !     end do
+        ! end do
+
+    end subroutine pairwise_distances
+
+    ! Branchless minimum image: subtract the nearest lattice translation (anint)
+    subroutine pairwise_orthorhombic(positions, n_particles, box, distances)
+        implicit none
+
+        integer, intent(in) :: n_particles
+        real(sp), intent(in) :: positions(n_particles, 3)
+        real(sp), intent(in) :: box(3, 3)
+        real(sp), intent(inout) :: distances(n_particles, n_particles)
+        integer :: i, j
+        real(sp) :: Lx, Ly, Lz, inv_Lx, inv_Ly, inv_Lz, dx, dy, dz, dist
+
+        Lx = box(1, 1)
+        Ly = box(2, 2)
+        Lz = box(3, 3)
+        inv_Lx = 1.0_sp / Lx
+        inv_Ly = 1.0_sp / Ly
+        inv_Lz = 1.0_sp / Lz
+
         !$omp parallel private(i, j, dx, dy, dz, dist)
         !$omp do schedule(dynamic)
         do j = 1, n_particles
@@ -37,15 +79,11 @@ contains
                 dx = positions(i, 1) - positions(j, 1)
                 dy = positions(i, 2) - positions(j, 2)
                 dz = positions(i, 3) - positions(j, 3)
-    
-                ! Apply periodic boundary conditions
-                if (dx > half_L) dx = dx - L
-                if (dx < -half_L) dx = dx + L
-                if (dy > half_L) dy = dy - L
-                if (dy < -half_L) dy = dy + L
-                if (dz > half_L) dz = dz - L
-                if (dz < -half_L) dz = dz + L
-    
+
+                dx = dx - Lx * anint(dx * inv_Lx)
+                dy = dy - Ly * anint(dy * inv_Ly)
+                dz = dz - Lz * anint(dz * inv_Lz)
+
                 dist = sqrt(dx**2 + dy**2 + dz**2)
                 distances(i, j) = dist
                 distances(j, i) = dist
@@ -54,20 +92,52 @@ contains
         !$omp end do
         !$omp end parallel
 
-        ! Get the end time
-        call system_clock(end_clock)
-  
-        ! Calculate the execution time
-        exec_time = real(end_clock - start_clock) / real(clock_rate)
-        print *, 'Execution time (seconds):', exec_time
+    end subroutine pairwise_orthorhombic
 
-        ! Debugging: Print the distances matrix
-        ! do i = 1, n_particles
-        !     do j = 1, n_particles
-        !         print *, 'distances(', i, ',', j, ') = ', distances(i, j)
-        !     end do
-        ! end do
+    ! Minimum image reduced along c, then b, then a: exact for separations
+    ! below half the smallest face width in the usual restricted triclinic cells
+    subroutine pairwise_triclinic(positions, n_particles, box, distances)
+        implicit none
 
-    end subroutine pairwise_distances
+        integer, intent(in) :: n_particles
+        real(sp), intent(in) :: positions(n_particles, 3)
+        real(sp), intent(in) :: box(3, 3)
+        real(sp), intent(inout) :: distances(n_particles, n_particles)
+        integer :: i, j
+        real(sp) :: inv_ax, inv_by, inv_cz, dx, dy, dz, s, dist
+
+        inv_ax = 1.0_sp / box(1, 1)
+        inv_by = 1.0_sp / box(2, 2)
+        inv_cz = 1.0_sp / box(3, 3)
+
+        !$omp parallel private(i, j, dx, dy, dz, s, dist)
+        !$omp do schedule(dynamic)
+        do j = 1, n_particles
+            !$omp simd
+            do i = j + 1, n_particles
+                dx = positions(i, 1) - positions(j, 1)
+                dy = positions(i, 2) - positions(j, 2)
+                dz = positions(i, 3) - positions(j, 3)
+
+                s = anint(dz * inv_cz)
+                dx = dx - box(1, 3) * s
+                dy = dy - box(2, 3) * s
+                dz = dz - box(3, 3) * s
+
+                s = anint(dy * inv_by)
+                dx = dx - box(1, 2) * s
+                dy = dy - box(2, 2) * s
+
+                dx = dx - box(1, 1) * anint(dx * inv_ax)
+
+                dist = sqrt(dx**2 + dy**2 + dz**2)
+                distances(i, j) = dist
+                distances(j, i) = dist
+            end do
+        end do
+        !$omp end do
+        !$omp end parallel
+
+    end subroutine pairwise_triclinic
 
 end module pairwise
\ No newline at end of file
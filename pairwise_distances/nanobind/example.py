@@ -0,0 +1,29 @@
+import numpy as np
+import time
+import pdists_module
+
+np.random.seed(42)
+
+n = 5000
+box = [10.0, 10.0, 10.0]
+positions = np.random.rand(n, 3).astype(np.float32) * 10.0
+
+start_time = time.time()
+d = pdists_module.distances(positions, box)
+print(f"distances: {d.shape} {time.time() - start_time} seconds")
+
+# Checked against numpy on a few rows
+dx = positions[:10, None, :] - positions[None, :, :]
+dx -= np.array(box, dtype=np.float32) * np.rint(dx / np.array(box, dtype=np.float32))
+assert np.allclose(d[:10], np.sqrt((dx ** 2).sum(-1)), atol=1e-4)
+
+c = pdists_module.condensed(positions, box)
+q = pdists_module.condensed(positions, box, quantize=(0.0, 10.0))
+print(f"condensed: {c.shape} {c.dtype}, quantized: {q.shape} {q.dtype}")
+
+# float64 positions are read in place too, no conversion copy
+counts = pdists_module.histogram(positions.astype(np.float64), box, n_bins=100, r_max=5.0)
+print(f"histogram: {counts.sum()} pairs below r_max")
+
+i, j, r = pdists_module.cutoff_pairs(positions, box, cutoff=1.0)
+print(f"cutoff_pairs: {len(r)} pairs")
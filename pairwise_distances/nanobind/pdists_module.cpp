@@ -0,0 +1,165 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/vector.h>
+#include <nanobind/ndarray.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+extern "C" {
+#include "../c/pdists.h"
+}
+
+namespace nb = nanobind;
+
+template <class T>
+using Positions = nb::ndarray<const T, nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+
+// malloc'ed buffer, freed on an exception until an array takes it over
+struct Free {
+    void operator()(void* p) const noexcept { std::free(p); }
+};
+
+template <class T>
+using Buffer = std::unique_ptr<T, Free>;
+
+// Numpy array owning a malloc'ed buffer, freed when the array is collected
+template <class T, size_t N>
+static nb::ndarray<nb::numpy, T> owning_array(Buffer<T> data, const std::array<size_t, N>& shape) {
+    nb::capsule owner(data.get(), [](void* p) noexcept { std::free(p); });
+    T* p = data.release();
+    return nb::ndarray<nb::numpy, T>(p, N, shape.data(), owner);
+}
+
+template <class T>
+static Buffer<T> allocate(size_t count) {
+    T* data = static_cast<T*>(std::malloc(std::max<size_t>(count, 1) * sizeof(T)));
+    if (!data) throw std::bad_alloc();
+    return Buffer<T>(data);
+}
+
+// Box lengths (orthorhombic) or the row-major 3x3 cell matrix, vectors as columns
+static std::array<float, 9> cell_matrix(const std::vector<double>& box) {
+    std::array<float, 9> h{};
+    if (box.size() == 3) {
+        h[0] = static_cast<float>(box[0]);
+        h[4] = static_cast<float>(box[1]);
+        h[8] = static_cast<float>(box[2]);
+    } else if (box.size() == 9) {
+        for (int k = 0; k < 9; ++k) h[k] = static_cast<float>(box[k]);
+    } else {
+        throw std::invalid_argument("box must hold 3 lengths or a 3x3 cell matrix");
+    }
+    return h;
+}
+
+// Runs a visitor over the positions without the GIL; either dtype is copied
+// once into the SoA float buffer the tiles are loaded from, float64 narrowed
+// on the way
+template <class T>
+static void visit(const Positions<T>& positions, const std::array<float, 9>& box, pdists_visitor visitor, void* ctx) {
+    int n = static_cast<int>(positions.shape(0));
+    nb::gil_scoped_release release;
+    if constexpr (std::is_same_v<T, float>) {
+        pairwise_visit(n, positions.data(), box.data(), visitor, ctx);
+    } else {
+        pairwise_visit_f64(n, positions.data(), box.data(), visitor, ctx);
+    }
+}
+
+template <class T>
+static nb::ndarray<nb::numpy, float> distances(const Positions<T>& positions, const std::vector<double>& box) {
+    size_t n = positions.shape(0);
+    std::array<float, 9> h = cell_matrix(box);  // checked before anything is allocated
+    Buffer<float> d = allocate<float>(n * n);
+    for (size_t i = 0; i < n; ++i) d.get()[i * n + i] = 0.0f;
+
+    pdists_dense dense = {static_cast<int>(n), d.get()};
+    visit(positions, h, pdists_dense_visit, &dense);
+    return owning_array(std::move(d), std::array<size_t, 2>{n, n});
+}
+
+template <class T>
+static nb::object condensed(const Positions<T>& positions, const std::vector<double>& box,
+                            const std::vector<float>& quantize) {
+    int n = static_cast<int>(positions.shape(0));
+    size_t size = pdists_condensed_size(n);
+    if (!quantize.empty() && (quantize.size() != 2 || !(quantize[1] > quantize[0]))) {
+        throw std::invalid_argument("quantize must be (r_min, r_max) with r_max > r_min");
+    }
+    std::array<float, 9> h = cell_matrix(box);
+
+    pdists_condensed c;
+    if (quantize.empty()) {
+        Buffer<float> d = allocate<float>(size);
+        pdists_condensed_init(&c, n, d.get(), 0, 0.0f, 0.0f);
+        visit(positions, h, pdists_condensed_visit, &c);
+        return nb::cast(owning_array(std::move(d), std::array<size_t, 1>{size}));
+    }
+
+    Buffer<uint16_t> q = allocate<uint16_t>(size);
+    pdists_condensed_init(&c, n, q.get(), 1, quantize[0], quantize[1]);
+    visit(positions, h, pdists_condensed_visit, &c);
+    return nb::cast(owning_array(std::move(q), std::array<size_t, 1>{size}));
+}
+
+template <class T>
+static nb::ndarray<nb::numpy, double> histogram(const Positions<T>& positions, const std::vector<double>& box,
+                                                int n_bins, float r_max) {
+    if (n_bins <= 0 || r_max <= 0.0f) throw std::invalid_argument("histogram needs n_bins > 0 and r_max > 0");
+
+    std::array<float, 9> cell = cell_matrix(box);
+
+    Buffer<double> counts = allocate<double>(n_bins);
+    pdists_histogram h;
+    pdists_histogram_init(&h, n_bins, r_max);
+    visit(positions, cell, pdists_histogram_visit, &h);
+    pdists_histogram_finish(&h, counts.get());
+    return owning_array(std::move(counts), std::array<size_t, 1>{static_cast<size_t>(n_bins)});
+}
+
+template <class T>
+static nb::tuple cutoff_pairs(const Positions<T>& positions, const std::vector<double>& box, float cutoff) {
+    std::array<float, 9> h = cell_matrix(box);
+
+    pdists_cutoff c;
+    pdists_pair_list pairs;
+    pdists_cutoff_init(&c, cutoff);
+    visit(positions, h, pdists_cutoff_visit, &c);
+    pdists_cutoff_finish(&c, &pairs);
+
+    // The C buffers are handed over as they are, owned from here on
+    Buffer<int> i(pairs.i), j(pairs.j);
+    Buffer<float> r(pairs.r);
+    std::array<size_t, 1> shape{pairs.size};
+    auto i_array = owning_array(std::move(i), shape);
+    auto j_array = owning_array(std::move(j), shape);
+    auto r_array = owning_array(std::move(r), shape);
+    return nb::make_tuple(i_array, j_array, r_array);
+}
+
+// float32 and float64 overloads; noconvert() so numpy never makes a silent copy
+template <class T>
+static void bind(nb::module_& m) {
+    m.def("distances", &distances<T>,
+          "Full n x n float32 distance matrix", nb::arg("positions").noconvert(), nb::arg("box"));
+    m.def("condensed", &condensed<T>,
+          "Upper triangle in scipy pdist order, float32, or uint16 over quantize = (r_min, r_max)",
+          nb::arg("positions").noconvert(), nb::arg("box"), nb::arg("quantize") = std::vector<float>());
+    m.def("histogram", &histogram<T>,
+          "Pair counts in n_bins bins over [0, r_max), the matrix is never stored",
+          nb::arg("positions").noconvert(), nb::arg("box"), nb::arg("n_bins"), nb::arg("r_max"));
+    m.def("cutoff_pairs", &cutoff_pairs<T>,
+          "Pairs (i, j, d) with i < j closer than cutoff, in no particular order",
+          nb::arg("positions").noconvert(), nb::arg("box"), nb::arg("cutoff"));
+}
+
+NB_MODULE(pdists_module, m) {
+    bind<float>(m);
+    bind<double>(m);
+}